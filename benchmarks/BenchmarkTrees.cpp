@@ -0,0 +1,163 @@
+#include "BenchmarkTrees.h"
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Расширения вперемешку, чтобы цвет и сортировка шли по разным веткам
+    const char* const EXTENSIONS[] = {".txt", ".cpp", ".h", ".png", ".tar.gz", ".json", ".log", ""};
+
+    std::string fileName(size_t index) {
+        return "file_" + std::to_string(index) + EXTENSIONS[index % (sizeof(EXTENSIONS) / sizeof(EXTENSIONS[0]))];
+    }
+
+    // Содержимое не пишется: размер задается через resize_file (разреженные файлы)
+    void createFile(const fs::path& path, uint64_t size, BenchmarkTrees::Tree& tree) {
+        std::ofstream(path).close();
+        if (size > 0) {
+            fs::resize_file(path, size);
+        }
+        tree.files++;
+    }
+
+    void createDirectory(const fs::path& path, BenchmarkTrees::Tree& tree) {
+        fs::create_directory(path);
+        tree.directories++;
+    }
+
+    void generateWide(BenchmarkTrees::Tree& tree) {
+        for (size_t d = 0; d < 2000; ++d) {
+            fs::path dir = tree.root / ("dir_" + std::to_string(d));
+            createDirectory(dir, tree);
+            for (size_t f = 0; f < 5; ++f) {
+                createFile(dir / fileName(f), 1024 * (f + 1), tree);
+            }
+        }
+    }
+
+    void generateDeep(const fs::path& path, size_t depth, BenchmarkTrees::Tree& tree) {
+        for (size_t f = 0; f < 4; ++f) {
+            createFile(path / fileName(f), 4096 * depth + f, tree);
+        }
+        if (depth == 0) {
+            return;
+        }
+        for (const char* name : {"left", "right"}) {
+            createDirectory(path / name, tree);
+            generateDeep(path / name, depth - 1, tree);
+        }
+    }
+
+    void generateTinyFiles(BenchmarkTrees::Tree& tree) {
+        for (size_t d = 0; d < 100; ++d) {
+            fs::path dir = tree.root / ("dir_" + std::to_string(d));
+            createDirectory(dir, tree);
+            for (size_t f = 0; f < 200; ++f) {
+                createFile(dir / fileName(f), f % 16, tree);
+            }
+        }
+    }
+
+    void generateHugeDirs(BenchmarkTrees::Tree& tree) {
+        for (size_t d = 0; d < 4; ++d) {
+            fs::path dir = tree.root / ("dir_" + std::to_string(d));
+            createDirectory(dir, tree);
+            for (size_t f = 0; f < 10000; ++f) {
+                createFile(dir / fileName(f), (f * 7919) % (64 * 1024 * 1024), tree);
+            }
+        }
+    }
+
+    // Корень всех деревьев; удаляется деструктором статического объекта
+    class Workspace {
+    public:
+        Workspace() {
+            const char* base = std::getenv("TREE_BENCH_DIR");
+            root_ = fs::path(base ? base : fs::temp_directory_path().string()) /
+                    ("tree-utility-bench-" + std::to_string(::getpid()));
+            fs::create_directories(root_);
+        }
+
+        ~Workspace() {
+            std::error_code ec;
+            fs::remove_all(root_, ec);
+        }
+
+        const fs::path& root() const { return root_; }
+
+    private:
+        fs::path root_;
+    };
+
+    std::mutex treesMutex;
+    std::array<std::unique_ptr<BenchmarkTrees::Tree>, static_cast<size_t>(BenchmarkTrees::Shape::COUNT)> trees;
+}
+
+const BenchmarkTrees::Tree& BenchmarkTrees::get(Shape shape) {
+    static Workspace workspace;
+
+    std::lock_guard<std::mutex> lock(treesMutex);
+    auto& tree = trees[static_cast<size_t>(shape)];
+    if (!tree) {
+        tree = std::make_unique<Tree>();
+        tree->root = workspace.root() / shapeName(shape);
+        fs::create_directories(tree->root);
+
+        switch (shape) {
+            case Shape::WIDE: generateWide(*tree); break;
+            case Shape::DEEP: generateDeep(tree->root, 10, *tree); break;
+            case Shape::TINY_FILES: generateTinyFiles(*tree); break;
+            case Shape::HUGE_DIRS: generateHugeDirs(*tree); break;
+            case Shape::COUNT: break;
+        }
+    }
+    return *tree;
+}
+
+const char* BenchmarkTrees::shapeName(Shape shape) {
+    switch (shape) {
+        case Shape::WIDE: return "wide";
+        case Shape::DEEP: return "deep";
+        case Shape::TINY_FILES: return "tiny_files";
+        case Shape::HUGE_DIRS: return "huge_dirs";
+        case Shape::COUNT: break;
+    }
+    return "unknown";
+}
+
+SilenceStdout::SilenceStdout() : saved_(std::cout.rdbuf(nullptr)) {}
+
+SilenceStdout::~SilenceStdout() {
+    std::cout.rdbuf(saved_);
+    std::cout.clear();
+}
+
+std::string wildcardToRegex(const std::string& pattern) {
+    std::string regexPattern;
+    for (char c : pattern) {
+        switch (c) {
+            case '*': regexPattern += ".*"; break;
+            case '?': regexPattern += '.'; break;
+            case '.': regexPattern += "\\."; break;
+            case '\\': regexPattern += "\\\\"; break;
+            case '+': regexPattern += "\\+"; break;
+            case '^': regexPattern += "\\^"; break;
+            case '$': regexPattern += "\\$"; break;
+            case '|': regexPattern += "\\|"; break;
+            case '(': regexPattern += "\\("; break;
+            case ')': regexPattern += "\\)"; break;
+            case '[': regexPattern += "\\["; break;
+            case ']': regexPattern += "\\]"; break;
+            case '{': regexPattern += "\\{"; break;
+            case '}': regexPattern += "\\}"; break;
+            default: regexPattern += c; break;
+        }
+    }
+    return regexPattern;
+}
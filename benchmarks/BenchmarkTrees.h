@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <filesystem>
+#include <iosfwd>
+#include <string>
+
+// Сгенерированные деревья для бенчмарков построителей.
+// Создаются один раз при первом обращении во временном каталоге
+// (или в TREE_BENCH_DIR) и удаляются при завершении процесса.
+class BenchmarkTrees {
+public:
+    enum class Shape {
+        WIDE,        // много директорий первого уровня по несколько файлов
+        DEEP,        // двоичное дерево директорий глубиной 10
+        TINY_FILES,  // десятки тысяч файлов по несколько байт
+        HUGE_DIRS,   // несколько директорий по 10 000 файлов
+        COUNT
+    };
+
+    struct Tree {
+        std::filesystem::path root;
+        size_t files = 0;
+        size_t directories = 0;
+
+        size_t entries() const { return files + directories; }
+    };
+
+    static const Tree& get(Shape shape);
+    static const char* shapeName(Shape shape);
+};
+
+// Шаблон с * и ? в эквивалентное регулярное выражение - прежний способ
+// сравнения имен в FilteredTreeBuilder, оставлен для сравнения с GlobMatcher
+std::string wildcardToRegex(const std::string& pattern);
+
+// Подавляет вывод в std::cout на время жизни объекта:
+// построители печатают служебные сообщения в конструкторах
+class SilenceStdout {
+public:
+    SilenceStdout();
+    ~SilenceStdout();
+
+private:
+    std::streambuf* saved_;
+};
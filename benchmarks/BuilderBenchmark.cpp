@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+#include "BenchmarkTrees.h"
+#include "DepthViewTreeBuilder.h"
+#include "FilteredTreeBuilder.h"
+#include "JSONTreeBuilder.h"
+#include "ModelTreeBuilder.h"
+#include "MultiThreadedTreeBuilder.h"
+#include "SyntheticFileSystem.h"
+#include "TreeBuilder.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Shape = BenchmarkTrees::Shape;
+    using Factory = std::function<std::unique_ptr<TreeBuilder>(const std::string& root)>;
+
+    // Синтетические деревья: только CPU-стоимость обхода и та же структура
+    // с задержкой на каждый вызов, как у сетевого хранилища
+    const char* const SYNTHETIC_SPECS[][2] = {
+        {"synthetic", "fanout=8,depth=3,files=20"},
+        {"synthetic_slow", "fanout=4,depth=3,files=10,latency=50us"},
+    };
+
+    // Полный buildTree без вывода: строки копятся в памяти построителя.
+    // entries_per_second считается по числу элементов исходного дерева.
+    void runBuild(benchmark::State& state, const std::string& root, size_t entries, const Factory& factory) {
+        SilenceStdout silence;
+        auto builder = factory(root);
+
+        for (auto _ : state) {
+            builder->buildTree(false);
+            benchmark::DoNotOptimize(builder->getTreeLines().data());
+        }
+
+        auto stats = builder->getStatistics();
+        state.counters["entries_per_second"] = benchmark::Counter(
+            static_cast<double>(entries), benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["entries"] = static_cast<double>(entries);
+        state.counters["files_seen"] = static_cast<double>(stats.totalFiles);
+        state.counters["dirs_seen"] = static_cast<double>(stats.totalDirectories);
+    }
+
+    void runSynthetic(benchmark::State& state, const std::string& specText, const Factory& factory) {
+        SyntheticFileSystem::Spec spec;
+        if (!SyntheticFileSystem::parseSpec(specText, spec)) {
+            state.SkipWithError("неверная спецификация синтетического дерева");
+            return;
+        }
+        const std::string root = "/synthetic";
+        auto provider = std::make_shared<SyntheticFileSystem>(spec, root);
+        FileSystem::setProvider(provider);
+        runBuild(state, root, provider->fileCount() + provider->directoryCount(), factory);
+        FileSystem::setProvider(nullptr);
+    }
+
+    void registerBuilder(const std::string& name, const Factory& factory) {
+        for (size_t i = 0; i < static_cast<size_t>(Shape::COUNT); ++i) {
+            Shape shape = static_cast<Shape>(i);
+            benchmark::RegisterBenchmark((name + "/" + BenchmarkTrees::shapeName(shape)).c_str(),
+                [shape, factory](benchmark::State& state) {
+                    const auto& tree = BenchmarkTrees::get(shape);
+                    runBuild(state, tree.root.string(), tree.entries(), factory);
+                })
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+        for (const auto& synthetic : SYNTHETIC_SPECS) {
+            std::string specText = synthetic[1];
+            benchmark::RegisterBenchmark((name + "/" + synthetic[0]).c_str(),
+                [specText, factory](benchmark::State& state) { runSynthetic(state, specText, factory); })
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+
+    // Число потоков: 1, 2, 4, ... и число аппаратных потоков
+    std::vector<size_t> threadCounts() {
+        size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<size_t> counts;
+        for (size_t count = 1; count < hardware; count *= 2) {
+            counts.push_back(count);
+        }
+        counts.push_back(hardware);
+        return counts;
+    }
+
+    bool registerAll() {
+        registerBuilder("BM_TreeBuilder", [](const std::string& root) {
+            return std::make_unique<TreeBuilder>(root);
+        });
+
+        for (size_t threads : threadCounts()) {
+            registerBuilder("BM_MultiThreadedTreeBuilder/threads:" + std::to_string(threads),
+                [threads](const std::string& root) {
+                    return std::make_unique<MultiThreadedTreeBuilder>(root, threads);
+                });
+        }
+
+        registerBuilder("BM_DepthViewTreeBuilder/depth:2", [](const std::string& root) {
+            return std::make_unique<DepthViewTreeBuilder>(root, 2);
+        });
+
+        // Типичный запрос: исходники крупнее 1 КБ
+        registerBuilder("BM_FilteredTreeBuilder/name_size", [](const std::string& root) {
+            auto builder = std::make_unique<FilteredTreeBuilder>(root);
+            builder->addNameFilter("*.cpp", true);
+            builder->addSizeFilter(constants::KB, ">");
+            return builder;
+        });
+
+        registerBuilder("BM_JSONTreeBuilder", [](const std::string& root) {
+            return std::make_unique<JSONTreeBuilder>(root);
+        });
+
+        // Тот же запрос, что и у FilteredTreeBuilder, но с параллельным обходом
+        size_t hardware = threadCounts().back();
+        registerBuilder("BM_ModelTreeBuilder/name_size/threads:" + std::to_string(hardware),
+            [hardware](const std::string& root) {
+                auto builder = std::make_unique<ModelTreeBuilder>(root, hardware);
+                builder->addNameFilter("*.cpp", true);
+                builder->addSizeFilter(constants::KB, ">");
+                return builder;
+            });
+        return true;
+    }
+
+    const bool registered = registerAll();
+}
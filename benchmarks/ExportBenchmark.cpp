@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include "JSONTreeRenderer.h"
+#include "JSONWriter.h"
+#include "TreeArchive.h"
+#include <nlohmann/json.hpp>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+    // Модель на 100 тысяч узлов: 1000 директорий по 100 файлов
+    const TreeModel& sampleModel() {
+        static const TreeModel model = [] {
+            std::mt19937_64 rng(2024);
+            TreeModel result;
+            TreeModel::Index root = result.addRoot("/data");
+            FileSystem::RawMetadata dirMeta;
+            dirMeta.mode = S_IFDIR | 0755;
+            for (int d = 0; d < 1000; ++d) {
+                result.addChild(root, "dir_" + std::to_string(d), dirMeta, true, false);
+            }
+            for (TreeModel::Index dir = 1; dir <= 1000; ++dir) {
+                for (int f = 0; f < 100; ++f) {
+                    FileSystem::RawMetadata meta;
+                    meta.mode = S_IFREG | 0644;
+                    meta.size = rng() >> (rng() % 60 + 4);
+                    meta.mtimeNs = static_cast<int64_t>(1600000000 + rng() % (3 * 365 * 86400)) * 1000000000LL;
+                    result.addChild(dir, "file_" + std::to_string(f) + ".txt", meta, false, false);
+                }
+            }
+            result.accumulateSizes();
+            return result;
+        }();
+        return model;
+    }
+
+    const TreeBuilder::Statistics sampleStats{100000, 1000, 0};
+
+    std::string encodeArchive() {
+        std::ostringstream out;
+        TreeArchive::write(out, sampleModel(), TreeView{}, sampleStats, 0, 0);
+        return out.str();
+    }
+
+    std::string encodeJSON() {
+        std::ostringstream out;
+        {
+            JSONWriter writer(out);
+            JSONTreeRenderer::render(writer, sampleModel(), TreeView{}, "/data", sampleStats);
+        }
+        return out.str();
+    }
+
+    void setCounters(benchmark::State& state, size_t bytes) {
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+        state.counters["bytes_per_node"] = static_cast<double>(bytes) / sampleModel().size();
+    }
+}
+
+static void BM_Export_Archive(benchmark::State& state) {
+    size_t bytes = 0;
+    for (auto _ : state) {
+        bytes = encodeArchive().size();
+        benchmark::DoNotOptimize(bytes);
+    }
+    setCounters(state, bytes);
+}
+BENCHMARK(BM_Export_Archive)->Unit(benchmark::kMillisecond);
+
+static void BM_Export_JSON(benchmark::State& state) {
+    size_t bytes = 0;
+    for (auto _ : state) {
+        bytes = encodeJSON().size();
+        benchmark::DoNotOptimize(bytes);
+    }
+    setCounters(state, bytes);
+}
+BENCHMARK(BM_Export_JSON)->Unit(benchmark::kMillisecond);
+
+// Чтение: двоичный формат в TreeModel против разбора JSON в DOM
+static void BM_Import_Archive(benchmark::State& state) {
+    std::string data = encodeArchive();
+    for (auto _ : state) {
+        TreeArchive::Tree tree;
+        benchmark::DoNotOptimize(TreeArchive::read(data, tree));
+    }
+    setCounters(state, data.size());
+}
+BENCHMARK(BM_Import_Archive)->Unit(benchmark::kMillisecond);
+
+static void BM_Import_JSON(benchmark::State& state) {
+    std::string data = encodeJSON();
+    for (auto _ : state) {
+        auto document = nlohmann::json::parse(data);
+        benchmark::DoNotOptimize(document);
+    }
+    setCounters(state, data.size());
+}
+BENCHMARK(BM_Import_JSON)->Unit(benchmark::kMillisecond);
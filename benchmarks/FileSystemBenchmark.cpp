@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include "BenchmarkTrees.h"
+#include "FileSystem.h"
+#include <regex>
+#include <vector>
+
+namespace {
+    // Пути файлов и директорий одного дерева в порядке обхода
+    const std::vector<fs::path>& samplePaths() {
+        static const std::vector<fs::path> paths = [] {
+            std::vector<fs::path> result;
+            const auto& tree = BenchmarkTrees::get(BenchmarkTrees::Shape::DEEP);
+            for (const auto& entry : fs::recursive_directory_iterator(tree.root)) {
+                result.push_back(entry.path());
+            }
+            return result;
+        }();
+        return paths;
+    }
+
+    const std::vector<std::string>& sampleNames() {
+        static const std::vector<std::string> names = [] {
+            std::vector<std::string> result;
+            for (const auto& path : samplePaths()) {
+                result.push_back(path.filename().string());
+            }
+            result.push_back("README");
+            result.push_back("archive.TAR.GZ");
+            result.push_back(".bashrc");
+            return result;
+        }();
+        return names;
+    }
+}
+
+// statx и форматирование полей одного элемента
+static void BM_GetFileInfo(benchmark::State& state) {
+    const auto& paths = samplePaths();
+    size_t i = 0;
+    for (auto _ : state) {
+        auto info = FileSystem::getFileInfo(paths[i++ % paths.size()]);
+        benchmark::DoNotOptimize(info);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetFileInfo)->ThreadRange(1, 8);
+
+static void BM_FormatTime(benchmark::State& state) {
+    // Время в пределах трех лет с шагом чуть больше часа
+    std::time_t time = 1600000000;
+    for (auto _ : state) {
+        std::string text = FileSystem::formatTime(time);
+        benchmark::DoNotOptimize(text);
+        time = 1600000000 + (time - 1600000000 + 3907) % (3 * 365 * 86400);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatTime);
+
+static void BM_FormatSize(benchmark::State& state) {
+    uint64_t size = 1;
+    for (auto _ : state) {
+        std::string text = FileSystem::formatSize(size);
+        benchmark::DoNotOptimize(text);
+        size = size * 31 % (1ULL << 42) + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatSize);
+
+static void BM_GetFileColor(benchmark::State& state) {
+    const auto& names = sampleNames();
+    std::vector<FileSystem::FileInfo> infos;
+    for (const auto& name : names) {
+        FileSystem::FileInfo info{};
+        info.name = name;
+        info.isHidden = !name.empty() && name[0] == '.';
+        infos.push_back(info);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(FileSystem::getFileColor(infos[i++ % infos.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetFileColor);
+
+// Сопоставление имени с шаблоном -n/-x прежним способом, через std::regex
+static void BM_WildcardRegexMatch(benchmark::State& state) {
+    static const char* const patterns[] = {"*.cpp", "file_1*", "*_?.h", "*.tar.gz"};
+    const std::regex pattern(wildcardToRegex(patterns[state.range(0)]),
+                             std::regex_constants::icase | std::regex_constants::optimize);
+    const auto& names = sampleNames();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::regex_match(names[i++ % names.size()], pattern));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(patterns[state.range(0)]);
+}
+BENCHMARK(BM_WildcardRegexMatch)->DenseRange(0, 3);
+
+static void BM_WildcardToRegex(benchmark::State& state) {
+    for (auto _ : state) {
+        std::regex pattern(wildcardToRegex("*_?.tar.gz"),
+                           std::regex_constants::icase | std::regex_constants::optimize);
+        benchmark::DoNotOptimize(pattern);
+    }
+}
+BENCHMARK(BM_WildcardToRegex);
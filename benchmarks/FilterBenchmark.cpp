@@ -0,0 +1,102 @@
+#include <benchmark/benchmark.h>
+#include "BenchmarkTrees.h"
+#include "GlobMatcher.h"
+#include <random>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    // Имена как в дереве исходников: основа, иногда суффикс и расширение
+    const std::vector<std::string>& sampleNames() {
+        static const std::vector<std::string> names = [] {
+            const char* stems[] = {"main", "TreeBuilder", "file_system", "README", "Makefile",
+                                   "test_parser", "index", "config", "CMakeLists", "utils"};
+            const char* suffixes[] = {"", "_test", "_impl", "2", ".backup"};
+            const char* extensions[] = {".cpp", ".h", ".hpp", ".txt", ".md", ".json", ".o", "", ".py", ".CPP"};
+            std::mt19937 rng(2024);
+            std::vector<std::string> result(4096);
+            for (auto& name : result) {
+                name = std::string(stems[rng() % 10]) + suffixes[rng() % 5] + extensions[rng() % 10];
+            }
+            return result;
+        }();
+        return names;
+    }
+
+    // Наборы шаблонов: (шаблон, включение)
+    std::vector<std::pair<std::string, bool>> patternSet(int64_t count) {
+        static const std::vector<std::pair<std::string, bool>> all = {
+            {"*.cpp", true}, {"*.h", true}, {"*.hpp", true}, {"*_test.*", false},
+            {"*.md", true}, {"Makefile", true}, {"CMakeLists.txt", true}, {"*.o", false},
+            {"test*", false}, {"*.backup", false}, {"*.json", true}, {"*.py", true},
+            {"main.?pp", true}, {"*_impl*", true}, {"index.*", true}, {"*.cc", true},
+            {"*.cxx", true}, {"*.tmp", false}, {"*.swp", false}, {"*~", false},
+            {"*.log", false}, {"config.*", true}, {"*util*", true}, {"?EADME*", true},
+        };
+        return {all.begin(), all.begin() + std::min<int64_t>(count, static_cast<int64_t>(all.size()))};
+    }
+}
+
+// Прежний путь: регулярное выражение на каждый шаблон, та же семантика,
+// что у GlobMatcher (любое включение, ни одного исключения)
+static void BM_NameFilter_Regex(benchmark::State& state) {
+    const auto& names = sampleNames();
+    std::vector<std::pair<std::regex, bool>> filters;
+    bool hasIncludes = false;
+    for (const auto& [pattern, include] : patternSet(state.range(0))) {
+        hasIncludes = hasIncludes || include;
+        filters.emplace_back(std::regex(wildcardToRegex(pattern),
+                                        std::regex_constants::icase | std::regex_constants::optimize),
+                             include);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& name = names[i++ % names.size()];
+        bool included = !hasIncludes;
+        bool excluded = false;
+        for (const auto& [regex, include] : filters) {
+            if ((include && included) || !std::regex_match(name, regex)) {
+                continue;
+            }
+            if (!include) {
+                excluded = true;
+                break;
+            }
+            included = true;
+        }
+        benchmark::DoNotOptimize(included && !excluded);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NameFilter_Regex)->Arg(1)->Arg(4)->Arg(24);
+
+static void BM_NameFilter_Glob(benchmark::State& state) {
+    const auto& names = sampleNames();
+    GlobMatcher matcher;
+    for (const auto& [pattern, include] : patternSet(state.range(0))) {
+        matcher.add(pattern, include);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matcher.matches(names[i++ % names.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NameFilter_Glob)->Arg(1)->Arg(4)->Arg(24);
+
+// Только автомат: шаблоны с ? и * в середине
+static void BM_NameFilter_GlobAutomaton(benchmark::State& state) {
+    const auto& names = sampleNames();
+    GlobMatcher matcher;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        matcher.add("*" + std::to_string(i) + "?*.c*", i % 3 != 0);
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(matcher.matches(names[i++ % names.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NameFilter_GlobAutomaton)->Arg(4)->Arg(24);
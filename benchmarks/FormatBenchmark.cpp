@@ -0,0 +1,208 @@
+#include <benchmark/benchmark.h>
+#include "FileSystem.h"
+#include "Formatter.h"
+#include "LineRenderer.h"
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+    // Набор метаданных, похожий на реальное дерево: время изменения
+    // в пределах нескольких лет, размеры от байтов до гигабайтов
+    const std::vector<FileSystem::RawMetadata>& sampleEntries() {
+        static const std::vector<FileSystem::RawMetadata> entries = [] {
+            std::mt19937_64 rng(2024);
+            std::vector<FileSystem::RawMetadata> result(4096);
+            for (auto& meta : result) {
+                meta.mode = S_IFREG | 0644;
+                meta.size = rng() >> (rng() % 60 + 4);
+                meta.mtimeNs = static_cast<int64_t>(1600000000 + rng() % (3 * 365 * 86400)) * 1000000000LL;
+            }
+            return result;
+        }();
+        return entries;
+    }
+
+    // Прежние реализации: ostringstream, put_time и посимвольная вставка разрядов
+    std::string legacyFormatTime(std::time_t tt) {
+        std::tm tm = {};
+        localtime_r(&tt, &tm);
+        std::ostringstream oss;
+        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+        return oss.str();
+    }
+
+    std::string legacyFormatNumber(uint64_t number) {
+        std::string numStr = std::to_string(number);
+        std::string result;
+        int count = 0;
+        for (int i = static_cast<int>(numStr.length()) - 1; i >= 0; i--) {
+            result = numStr[i] + result;
+            count++;
+            if (count % 3 == 0 && i != 0) {
+                result = " " + result;
+            }
+        }
+        return result;
+    }
+
+    std::string legacyFormatSizeBothSystems(uint64_t size) {
+        std::stringstream binary;
+        binary << std::fixed << std::setprecision(1);
+        if (size < constants::KB) {
+            binary << size << " B";
+        } else if (size < constants::MB) {
+            binary << static_cast<double>(size) / constants::KB << " KiB";
+        } else if (size < constants::GB) {
+            binary << static_cast<double>(size) / constants::MB << " MiB";
+        } else {
+            binary << static_cast<double>(size) / constants::GB << " GiB";
+        }
+
+        std::stringstream decimal;
+        decimal << std::fixed << std::setprecision(1);
+        if (size < 1000) {
+            decimal << size << " B";
+        } else if (size < 1000000) {
+            decimal << static_cast<double>(size) / 1000 << " KB";
+        } else if (size < 1000000000) {
+            decimal << static_cast<double>(size) / 1000000 << " MB";
+        } else {
+            decimal << static_cast<double>(size) / 1000000000 << " GB";
+        }
+
+        std::stringstream result;
+        result << binary.str() << " / " << decimal.str() << " (" << legacyFormatNumber(size) << " bytes)";
+        return result.str();
+    }
+
+    std::string legacyFormatSize(uint64_t size) {
+        if (size < constants::KB) return std::to_string(size) + " B";
+        if (size < constants::MB) return std::to_string(size / constants::KB) + " KB";
+        if (size < constants::GB) return std::to_string(size / constants::MB) + " MB";
+        if (size < constants::TB) return std::to_string(size / constants::GB) + " GB";
+        return std::to_string(size / constants::TB) + " TB";
+    }
+}
+
+// Полный набор полей строки дерева на один элемент: размер, время, права
+static void BM_FormatEntry_Legacy(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& meta = entries[i++ % entries.size()];
+        std::string size = legacyFormatSize(meta.size);
+        std::string time = legacyFormatTime(static_cast<std::time_t>(meta.mtimeNs / 1000000000LL));
+        std::string permissions = FileSystem::formatPermissions(static_cast<fs::perms>(meta.mode & 0777));
+        benchmark::DoNotOptimize(size);
+        benchmark::DoNotOptimize(time);
+        benchmark::DoNotOptimize(permissions);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatEntry_Legacy)->ThreadRange(1, 8);
+
+static void BM_FormatEntry_Kernels(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    char size[Formatter::SIZE_BUFFER_SIZE];
+    char time[Formatter::TIME_BUFFER_SIZE];
+    char permissions[Formatter::PERMISSIONS_BUFFER_SIZE];
+    size_t i = 0;
+    for (auto _ : state) {
+        const auto& meta = entries[i++ % entries.size()];
+        benchmark::DoNotOptimize(Formatter::formatSize(meta.size, size));
+        benchmark::DoNotOptimize(Formatter::formatTime(meta.mtimeNs / 1000000000LL, time));
+        benchmark::DoNotOptimize(Formatter::formatPermissions(meta.mode, permissions));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatEntry_Kernels)->ThreadRange(1, 8);
+
+// FileInfo целиком, как его получают построители после stat
+static void BM_MakeFileInfo(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    const std::string name = "example.txt";
+    size_t i = 0;
+    for (auto _ : state) {
+        auto info = FileSystem::makeFileInfo(name, entries[i++ % entries.size()], false);
+        benchmark::DoNotOptimize(info);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MakeFileInfo)->ThreadRange(1, 8);
+
+// Строка дерева из FileInfo и напрямую из сырых метаданных
+static void BM_RenderLine_FileInfo(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    const std::string name = "example.txt";
+    LineRenderer renderer;
+    renderer.pushLevel(false);
+    size_t i = 0;
+    for (auto _ : state) {
+        renderer.beginLine(false);
+        renderer.appendEntry(FileSystem::makeFileInfo(name, entries[i++ % entries.size()], false));
+        benchmark::DoNotOptimize(renderer.line().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RenderLine_FileInfo);
+
+static void BM_RenderLine_Raw(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    const std::string name = "example.txt";
+    LineRenderer renderer;
+    renderer.pushLevel(false);
+    size_t i = 0;
+    for (auto _ : state) {
+        renderer.beginLine(false);
+        renderer.appendEntry(name, entries[i++ % entries.size()], false);
+        benchmark::DoNotOptimize(renderer.line().data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RenderLine_Raw);
+
+static void BM_FormatSizeBothSystems_Legacy(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    size_t i = 0;
+    for (auto _ : state) {
+        std::string text = legacyFormatSizeBothSystems(entries[i++ % entries.size()].size);
+        benchmark::DoNotOptimize(text);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatSizeBothSystems_Legacy);
+
+static void BM_FormatSizeBothSystems_Kernel(benchmark::State& state) {
+    const auto& entries = sampleEntries();
+    char buffer[Formatter::SIZE_BOTH_BUFFER_SIZE];
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Formatter::formatSizeBothSystems(entries[i++ % entries.size()].size, buffer));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FormatSizeBothSystems_Kernel);
+
+static void BM_FormatNumber_Legacy(benchmark::State& state) {
+    uint64_t value = state.range(0);
+    for (auto _ : state) {
+        std::string text = legacyFormatNumber(value);
+        benchmark::DoNotOptimize(text);
+    }
+}
+BENCHMARK(BM_FormatNumber_Legacy)->Arg(999)->Arg(252004745)->Arg(UINT64_MAX / 2);
+
+static void BM_FormatNumber_Kernel(benchmark::State& state) {
+    uint64_t value = state.range(0);
+    char buffer[Formatter::NUMBER_BUFFER_SIZE];
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Formatter::formatNumber(value, buffer));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FormatNumber_Kernel)->Arg(999)->Arg(252004745)->Arg(UINT64_MAX / 2);
@@ -0,0 +1,137 @@
+#include "Profiler.h"
+#include <cstdlib>
+#include <new>
+
+// Подсчет выделений кучи для отчета --profile. Файл входит только
+// в исполняемый tree-utility, библиотеки и бенчмарки его не получают.
+// Пока профилирование выключено, накладные расходы - одна relaxed-загрузка флага.
+// Заменены все формы operator new; память берется из malloc/aligned_alloc,
+// поэтому все формы operator delete освобождают ее через free.
+
+namespace {
+    void* allocate(std::size_t size) {
+        Profiler::recordAllocation();
+        if (size == 0) {
+            size = 1;
+        }
+        while (true) {
+            if (void* ptr = std::malloc(size)) {
+                return ptr;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+        Profiler::recordAllocation();
+        auto align = static_cast<std::size_t>(alignment);
+        if (align < sizeof(void*)) {
+            align = sizeof(void*);
+        }
+        // aligned_alloc требует размер, кратный выравниванию
+        size = size == 0 ? align : (size + align - 1) / align * align;
+        while (true) {
+            if (void* ptr = std::aligned_alloc(align, size)) {
+                return ptr;
+            }
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+    }
+
+    template <typename Allocate>
+    void* allocateNoThrow(Allocate allocate) noexcept {
+        try {
+            return allocate();
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateNoThrow([size] { return allocate(size); });
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocateNoThrow([size] { return allocate(size); });
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateNoThrow([size, alignment] { return allocateAligned(size, alignment); });
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateNoThrow([size, alignment] { return allocateAligned(size, alignment); });
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
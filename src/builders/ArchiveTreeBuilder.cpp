@@ -0,0 +1,42 @@
+#include "ArchiveTreeBuilder.h"
+#include "JSONTreeRenderer.h"
+#include "TreeTextRenderer.h"
+#include <stdexcept>
+
+ArchiveTreeBuilder::ArchiveTreeBuilder(const std::string& archivePath)
+    : TreeBuilder(archivePath), archivePath_(archivePath) {}
+
+// Скрытые объекты отобраны при сохранении, showHidden здесь ничего не меняет
+void ArchiveTreeBuilder::buildTree([[maybe_unused]] bool showHidden) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    treeLines_.clear();
+    displayStats_ = DisplayStatistics{};
+
+    if (!TreeArchive::load(archivePath_, tree_)) {
+        throw std::runtime_error("не удалось загрузить дерево из " + archivePath_ +
+                                 ": файл не найден, поврежден или не является деревом tree-utility");
+    }
+
+    // Путь корня - тот, что был при сохранении
+    rootPath_ = std::string(tree_.model.name(TreeModel::ROOT));
+    stats_ = tree_.stats;
+    hiddenObjectsCount_ = tree_.hiddenObjects;
+    ignoredObjectsCount_ = tree_.ignoredObjects;
+    displayStats_.displayedDirectories = stats_.totalDirectories;
+    displayStats_.displayedFiles = stats_.totalFiles;
+    displayStats_.displayedSize = stats_.totalSize;
+
+    if (textOutput_) {
+        BufferSink buffer(treeLines_);
+        TreeTextRenderer::render(tree_.model, tree_.view, sink_ ? *sink_ : static_cast<OutputSink&>(buffer));
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    displayStats_.buildTimeMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+}
+
+void ArchiveTreeBuilder::writeJSON(JSONWriter& writer) const {
+    Profiler::Scope scope(Profiler::Phase::JSON);
+    JSONTreeRenderer::render(writer, tree_.model, tree_.view, rootPath_.string(), stats_);
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "TreeBuilder.h"
+#include "TreeArchive.h"
+#include "JSONWriter.h"
+
+// Дерево из файла --format bin (--load FILE): текст или JSON без обхода диска.
+// Выводится то, что было сохранено, с фильтрами и глубиной того запуска.
+class ArchiveTreeBuilder : public TreeBuilder {
+public:
+    explicit ArchiveTreeBuilder(const std::string& archivePath);
+
+    // Поврежденный или чужой файл - std::runtime_error
+    void buildTree(bool showHidden = false) override;
+
+    void setTextOutput(bool enabled) { textOutput_ = enabled; }
+    void writeJSON(JSONWriter& writer) const;
+
+private:
+    std::string archivePath_;
+    bool textOutput_ = true;
+    TreeArchive::Tree tree_;
+};
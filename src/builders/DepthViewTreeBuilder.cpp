@@ -1,6 +1,8 @@
 #include "DepthViewTreeBuilder.h"
+#include "Formatter.h"
 #include <iostream>
 #include <algorithm> 
+#include <thread>
 
 DepthViewTreeBuilder::DepthViewTreeBuilder(const std::string& rootPath, size_t maxDepth)
     : TreeBuilder(rootPath), maxDepth_(maxDepth), currentDepth_(0) {}
@@ -10,112 +12,115 @@ void DepthViewTreeBuilder::buildTree(bool showHidden) {
     stats_ = Statistics{0, 0, 0};
     displayStats_ = DisplayStatistics{};
     currentDepth_ = 0;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
     
-    treeLines_.push_back(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+    renderer_.clear();
+    pendingLines_.clear();
+    summaries_.clear();
+    if (cutoffMode_ == CutoffMode::SUMMARY) {
+        if (threadCount_ > 1) {
+            std::cout << "Используется потоков: " << threadCount_ << std::endl;
+        }
+        pool_ = std::make_unique<WorkStealingPool>(threadCount_);
+    }
+    outputLine(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+    
+    traverseDirectory(rootPath_, true, showHidden, true);
+    
+    if (pool_) {
+        // Поддеревья считались параллельно с обходом видимой части
+        pool_->wait();
+        pool_.reset();
+        for (const auto& summary : summaries_) {
+            appendSummary(pendingLines_[summary.line], summary);
+        }
+        for (const auto& line : pendingLines_) {
+            emitLine(line);
+        }
+        pendingLines_.clear();
+        summaries_.clear();
+    }
     
-    traverseDirectory(rootPath_, "", true, showHidden, true);
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
 }
 
-void DepthViewTreeBuilder::traverseDirectory(const fs::path& path, 
-                                           const std::string& prefix, 
-                                           bool isLast,
-                                           bool showHidden,
-                                           bool isRoot) {
+uint64_t DepthViewTreeBuilder::traverseDirectory(const fs::path& path, 
+                                               bool isLast,
+                                               bool showHidden,
+                                               bool isRoot) {
     if (maxDepth_ > 0 && currentDepth_ >= maxDepth_) {
         if (!isRoot) {
             displayStats_.hiddenByDepth++;
         }
-        return;
+        return 0;
     }
     
     if (!isRoot) {
-        auto info = FileSystem::getFileInfo(path);
-        std::string connector = isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-        
-        treeLines_.push_back(prefix + connector + formatTreeLine(info, connector));
+        renderDirectoryLine(path, isLast);
+        outputLine(renderer_.line());
         stats_.totalDirectories++;
         displayStats_.displayedDirectories++;
     }
     
-    currentDepth_++;
-    
-    std::string newPrefix = prefix;
-    if (isLast) {
-        newPrefix += constants::TREE_SPACE;
-    } else {
-        newPrefix += constants::TREE_VERTICAL;
+    std::vector<DirEntry> entries;
+    if (!listDirectory(path, showHidden, entries)) {
+        return 0;
     }
     
-    std::vector<fs::directory_entry> entries;
+    sortEntries(entries);
     
-    try {
-        for (const auto& entry : fs::directory_iterator(path)) {
-            bool isHidden = FileSystem::isHidden(entry.path());
-            
-            if (!isHidden || showHidden) {
-                entries.push_back(entry);
-            } else {
-                hiddenObjectsCount_++;
-            }
-        }
-    } catch (const fs::filesystem_error&) {
-        currentDepth_--;
-        return;
-    }
+    currentDepth_++;
+    renderer_.pushLevel(isLast);
     
-    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
-        if (a.is_directory() != b.is_directory()) {
-            return a.is_directory() > b.is_directory();
-        }
-        return a.path().filename().string() < b.path().filename().string();
-    });
+    uint64_t subtreeSize = 0;
+    MetadataBatch files(entries);
     
     for (size_t i = 0; i < entries.size(); ++i) {
         const auto& entry = entries[i];
         bool entryIsLast = (i == entries.size() - 1);
         
-        if (entry.is_directory()) {
+        if (entry.isDirectory) {
             if (maxDepth_ > 0 && currentDepth_ >= maxDepth_) {
-                auto info = FileSystem::getFileInfo(entry.path());
-                std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-                
-                treeLines_.push_back(newPrefix + connector + formatTreeLine(info, connector) + " " + 
-                                   ColorManager::getHiddenContentColor() + "(содержимое скрыто)" + ColorManager::getReset());
+                // На границе все директории выводятся строкой, так что их stat
+                // идут одной пачкой с файлами; содержимое читается только для итогов
+                const auto& meta = files.at(i);
+                renderEntryLine(entry.name, meta, files.isSymlink(i), entryIsLast);
+                if (cutoffMode_ == CutoffMode::SUMMARY) {
+                    summaries_.emplace_back();
+                    Summary& summary = summaries_.back();
+                    summary.line = pendingLines_.size();
+                    pool_->submit([this, path = entry.path, &summary, showHidden] {
+                        summarizeDirectory(path, summary, showHidden);
+                    });
+                } else {
+                    renderer_.append(" ");
+                    renderer_.append(ColorManager::getHiddenContentColor());
+                    renderer_.append("(содержимое скрыто)");
+                    renderer_.append(ColorManager::getReset());
+                }
+                outputLine(renderer_.line());
                 stats_.totalDirectories++;
                 displayStats_.displayedDirectories++;
                 displayStats_.hiddenByDepth++;
             } else {
-                traverseDirectory(entry.path(), newPrefix, entryIsLast, showHidden, false);
+                subtreeSize += traverseDirectory(entry.path, entryIsLast, showHidden, false);
             }
         } else {
-            auto info = FileSystem::getFileInfo(entry.path());
-            std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-            
-            treeLines_.push_back(newPrefix + connector + formatTreeLine(info, connector));
+            const auto& meta = files.at(i);
+            uint64_t size = FileSystem::entrySize(meta);
+            renderEntryLine(entry.name, meta, files.isSymlink(i), entryIsLast);
+            outputLine(renderer_.line());
             stats_.totalFiles++;
-            stats_.totalSize += info.size;
+            stats_.totalSize += size;
             displayStats_.displayedFiles++;
-            displayStats_.displayedSize += info.size;
+            displayStats_.displayedSize += size;
+            subtreeSize += size;
         }
     }
     
+    renderer_.popLevel();
     currentDepth_--;
-}
-
-std::string DepthViewTreeBuilder::formatTreeLine(const FileSystem::FileInfo& info, 
-                                               const std::string& connector) const {
-    std::string nameColor = FileSystem::getFileColor(info);  
-    if (info.isDirectory) {
-        return nameColor + info.name + ColorManager::getReset() + " " + 
-               ColorManager::getDirLabelColor() + "[DIR]" + ColorManager::getReset() + " | " + 
-               ColorManager::getDateColor() + info.lastModified + ColorManager::getReset() + " | " + 
-               ColorManager::getPermissionsColor() + info.permissions + ColorManager::getReset();
-    } else {
-        return nameColor + info.name + ColorManager::getReset() + " (" + 
-               ColorManager::getSizeColor() + info.sizeFormatted + ColorManager::getReset() + ") | " + 
-               ColorManager::getDateColor() + info.lastModified + ColorManager::getReset() + " | " + 
-               ColorManager::getPermissionsColor() + info.permissions + ColorManager::getReset();
-    }
+    return subtreeSize;
 }
 
 void DepthViewTreeBuilder::setMaxDepth(size_t maxDepth) {
@@ -124,4 +129,77 @@ void DepthViewTreeBuilder::setMaxDepth(size_t maxDepth) {
 
 size_t DepthViewTreeBuilder::getMaxDepth() const {
     return maxDepth_;
-}
\ No newline at end of file
+}
+
+void DepthViewTreeBuilder::setCutoffMode(CutoffMode mode, size_t threadCount) {
+    cutoffMode_ = mode;
+    threadCount_ = threadCount;
+    if (threadCount_ == 0) {
+        unsigned int hwThreads = std::thread::hardware_concurrency();
+        threadCount_ = (hwThreads == 0) ? 2 : static_cast<size_t>(hwThreads);
+    }
+}
+
+void DepthViewTreeBuilder::outputLine(const std::string& line) {
+    if (cutoffMode_ == CutoffMode::SUMMARY) {
+        pendingLines_.push_back(line);
+    } else {
+        emitLine(line);
+    }
+}
+
+void DepthViewTreeBuilder::summarizeDirectory(const fs::path& path, Summary& summary, bool showHidden) {
+    std::vector<DirEntry> entries;
+    SkippedCounts skipped;
+    if (!readDirectoryEntries(path, showHidden, entries, skipped)) {
+        summary.unreadable++;
+        return;
+    }
+    
+    // Размер нужен только файлам; директории видны по d_type
+    std::vector<const fs::path*> files;
+    uint64_t directories = 0;
+    for (const auto& entry : entries) {
+        if (entry.isDirectory) {
+            directories++;
+        } else {
+            files.push_back(&entry.path);
+        }
+    }
+    std::vector<FileSystem::RawMetadata> metas;
+    std::vector<char> symlinks;
+    FileSystem::resolveMetadataBatch(files, metas, symlinks);
+    uint64_t size = 0;
+    for (const auto& meta : metas) {
+        size += meta.size;
+    }
+    summary.files += files.size();
+    summary.directories += directories;
+    summary.size += size;
+    
+    for (auto& entry : entries) {
+        if (entry.isDirectory) {
+            pool_->submit([this, path = std::move(entry.path), &summary, showHidden] {
+                summarizeDirectory(path, summary, showHidden);
+            });
+        }
+    }
+}
+
+void DepthViewTreeBuilder::appendSummary(std::string& line, const Summary& summary) const {
+    char buffer[Formatter::NUMBER_BUFFER_SIZE];
+    line += ' ';
+    line += ColorManager::getHiddenContentColor();
+    line += "(файлов: ";
+    line.append(buffer, Formatter::formatNumber(summary.files, buffer));
+    line += ", директорий: ";
+    line.append(buffer, Formatter::formatNumber(summary.directories, buffer));
+    line += ", ";
+    line.append(buffer, Formatter::formatSize(summary.size, buffer));
+    if (summary.unreadable > 0) {
+        line += ", нет доступа: ";
+        line.append(buffer, Formatter::formatNumber(summary.unreadable, buffer));
+    }
+    line += ')';
+    line += ColorManager::getReset();
+}
@@ -1,24 +1,51 @@
 #pragma once
 #include "TreeBuilder.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <deque>
+#include <memory>
 
 class DepthViewTreeBuilder : public TreeBuilder {
 public:
+    // Что выводится у директорий на границе глубины
+    enum class CutoffMode {
+        FAST,     // "(содержимое скрыто)": ниже границы диск не читается
+        SUMMARY   // файлов, директорий и размер скрытого поддерева (как du)
+    };
+
     DepthViewTreeBuilder(const std::string& rootPath, size_t maxDepth = 0);
-    
+
     void buildTree(bool showHidden = false) override;
     void setMaxDepth(size_t maxDepth);
     size_t getMaxDepth() const;
+    // Поддеревья для SUMMARY считаются параллельно в threadCount потоков (0 - по числу ядер)
+    void setCutoffMode(CutoffMode mode, size_t threadCount = 1);
+    bool isMultiThreaded() const { return cutoffMode_ == CutoffMode::SUMMARY && threadCount_ > 1; }
 
 private:
+    // Итог скрытого поддерева; задачи его обхода добавляют сюда свои доли
+    struct Summary {
+        std::atomic<uint64_t> files{0};
+        std::atomic<uint64_t> directories{0};
+        std::atomic<uint64_t> size{0};
+        std::atomic<uint64_t> unreadable{0};
+        size_t line = 0;
+    };
+
     size_t maxDepth_;
     size_t currentDepth_;
-    
-    std::string formatTreeLine(const FileSystem::FileInfo& info, 
-                              const std::string& connector) const override;
+    CutoffMode cutoffMode_ = CutoffMode::FAST;
+    size_t threadCount_ = 1;
+    std::unique_ptr<WorkStealingPool> pool_;
+    // В режиме SUMMARY строки ждут итогов поддеревьев и выводятся в конце
+    std::vector<std::string> pendingLines_;
+    std::deque<Summary> summaries_;
 
-    void traverseDirectory(const std::filesystem::path& path, 
-                          const std::string& prefix, 
-                          bool isLast,
-                          bool showHidden,
-                          bool isRoot = false) override;
-};
\ No newline at end of file
+    uint64_t traverseDirectory(const std::filesystem::path& path,
+                              bool isLast,
+                              bool showHidden,
+                              bool isRoot = false) override;
+    void outputLine(const std::string& line);
+    void summarizeDirectory(const std::filesystem::path& path, Summary& summary, bool showHidden);
+    void appendSummary(std::string& line, const Summary& summary) const;
+};
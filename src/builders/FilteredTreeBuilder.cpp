@@ -1,7 +1,10 @@
 #include "FilteredTreeBuilder.h"
+#include <algorithm>
+#include <charconv>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
+#include <sys/stat.h>
 
 FilteredTreeBuilder::FilteredTreeBuilder(const std::string& rootPath) 
     : TreeBuilder(rootPath), maxDepth_(0), currentDepth_(0), directoriesOnly_(false) {}
@@ -19,68 +22,111 @@ void FilteredTreeBuilder::addDateFilter(const std::string& date, const std::stri
     filter.type = Filter::Type::DATE;
     filter.operation = operation;
     
-    std::tm tm = {};
-    std::istringstream ss(date);
-    ss >> std::get_time(&tm, "%Y-%m-%d");
-    if (ss.fail()) {
-        ss.clear();
-        ss.str(date);
-        ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    int64_t ageNs = 0;
+    int64_t unitNs = 0;
+    int64_t startNs = 0;
+    int64_t endNs = 0;
+    if (parseAge(date, ageNs, unitNs)) {
+        // Возраст меньше - время изменения больше; "== 1d" - от суток до двух
+        int64_t pointNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count() - ageNs;
+        if (operation == "==") {
+            setTimeRange(filter, "==", pointNs - unitNs + 1, pointNs + 1);
+        } else {
+            std::string mirrored = operation;
+            mirrored[0] = operation[0] == '<' ? '>' : '<';
+            setTimeRange(filter, mirrored, pointNs, pointNs + 1);
+        }
+    } else if (parseLocalTime(date, startNs, endNs)) {
+        setTimeRange(filter, operation, startNs, endNs);
+    } else {
+        std::cerr << "Ошибка: неверный формат даты. Используйте YYYY-MM-DD, YYYY-MM-DD HH:MM:SS "
+                  << "или возраст: 30s, 15m, 12h, 7d, 2w" << std::endl;
+        return;
     }
+    filters_.push_back(filter);
     
-    if (!ss.fail()) {
-        std::time_t tt = std::mktime(&tm);
-        filter.dateValue = std::chrono::system_clock::from_time_t(tt);
-        filters_.push_back(filter);
-        
-        std::cout << "Добавлен фильтр даты: " << operation << " " << date << std::endl;
-    } else {
-        std::cerr << "Ошибка: неверный формат даты. Используйте YYYY-MM-DD или YYYY-MM-DD HH:MM:SS" << std::endl;
+    *log_ << "Добавлен фильтр даты: " << operation << " " << date << std::endl;
+}
+
+bool FilteredTreeBuilder::parseAge(const std::string& text, int64_t& ageNs, int64_t& unitNs) {
+    constexpr int64_t SECOND = 1000000000LL;
+    if (text.size() < 2) {
+        return false;
+    }
+    switch (text.back()) {
+        case 's': unitNs = SECOND; break;
+        case 'm': unitNs = 60 * SECOND; break;
+        case 'h': unitNs = 3600 * SECOND; break;
+        case 'd': unitNs = 86400 * SECOND; break;
+        case 'w': unitNs = 7 * 86400 * SECOND; break;
+        default: return false;
+    }
+    int64_t count = 0;
+    const char* end = text.data() + text.size() - 1;
+    auto result = std::from_chars(text.data(), end, count);
+    if (result.ec != std::errc() || result.ptr != end || count < 0 ||
+        count > std::numeric_limits<int64_t>::max() / unitNs / 2) {
+        return false;
     }
+    ageNs = count * unitNs;
+    return true;
 }
 
-void FilteredTreeBuilder::addNameFilter(const std::string& pattern, bool include) {
-    Filter filter;
-    filter.type = Filter::Type::NAME;
-    filter.include = include;
-    
-    try {
-        std::string regexPattern = wildcardToRegex(pattern);
-        filter.namePattern = std::regex(regexPattern, 
-            std::regex_constants::icase | std::regex_constants::optimize);
-        filters_.push_back(filter);
-        
-        std::string filterType = include ? "включения" : "исключения";
-        std::cout << "Добавлен фильтр имени (" << filterType << "): " 
-                  << pattern << " -> " << regexPattern << std::endl;
-        
-    } catch (const std::regex_error& e) {
-        std::cerr << "Ошибка в шаблоне имени: " << e.what() << std::endl;
+bool FilteredTreeBuilder::parseLocalTime(const std::string& text, int64_t& startNs, int64_t& endNs) {
+    // Дата без времени - целые сутки, с временем - одна секунда
+    for (bool dateOnly : {true, false}) {
+        std::tm tm = {};
+        std::istringstream ss(text);
+        ss >> std::get_time(&tm, dateOnly ? "%Y-%m-%d" : "%Y-%m-%d %H:%M:%S");
+        if (ss.fail() || ss.peek() != std::char_traits<char>::eof()) {
+            continue;
+        }
+        tm.tm_isdst = -1;
+        std::tm next = tm;
+        if (dateOnly) {
+            next.tm_mday++;
+        } else {
+            next.tm_sec++;
+        }
+        std::time_t start = std::mktime(&tm);
+        std::time_t end = std::mktime(&next);
+        if (start == -1 || end == -1) {
+            return false;
+        }
+        startNs = static_cast<int64_t>(start) * 1000000000LL;
+        endNs = static_cast<int64_t>(end) * 1000000000LL;
+        return true;
+    }
+    return false;
+}
+
+void FilteredTreeBuilder::setTimeRange(Filter& filter, const std::string& operation, int64_t startNs, int64_t endNs) {
+    if (operation == ">") filter.minTimeNs = endNs;
+    else if (operation == ">=") filter.minTimeNs = startNs;
+    else if (operation == "<") filter.maxTimeNs = startNs;
+    else if (operation == "<=") filter.maxTimeNs = endNs;
+    else {
+        filter.minTimeNs = startNs;
+        filter.maxTimeNs = endNs;
     }
 }
 
-std::string FilteredTreeBuilder::wildcardToRegex(const std::string& pattern) const {
-    std::string regexPattern;
-    for (char c : pattern) {
-        switch (c) {
-            case '*': regexPattern += ".*"; break;
-            case '?': regexPattern += '.'; break;
-            case '.': regexPattern += "\\."; break;
-            case '\\': regexPattern += "\\\\"; break;
-            case '+': regexPattern += "\\+"; break;
-            case '^': regexPattern += "\\^"; break;
-            case '$': regexPattern += "\\$"; break;
-            case '|': regexPattern += "\\|"; break;
-            case '(': regexPattern += "\\("; break;
-            case ')': regexPattern += "\\)"; break;
-            case '[': regexPattern += "\\["; break;
-            case ']': regexPattern += "\\]"; break;
-            case '{': regexPattern += "\\{"; break;
-            case '}': regexPattern += "\\}"; break;
-            default: regexPattern += c; break;
+void FilteredTreeBuilder::addNameFilter(const std::string& pattern, bool include) {
+    if (pattern.size() > 1 && pattern.back() == '/') {
+        if (include) {
+            std::cerr << "Ошибка: шаблон директории (с / на конце) допустим только для исключения: "
+                      << pattern << std::endl;
+            return;
         }
+        directoryMatcher_.add(pattern.substr(0, pattern.size() - 1), false);
+        *log_ << "Добавлен фильтр исключения директорий: " << pattern << std::endl;
+        return;
     }
-    return regexPattern;
+    nameMatcher_.add(pattern, include);
+    
+    std::string filterType = include ? "включения" : "исключения";
+    *log_ << "Добавлен фильтр имени (" << filterType << "): " << pattern << std::endl;
 }
 
 void FilteredTreeBuilder::setMaxDepth(size_t maxDepth) {
@@ -93,6 +139,8 @@ void FilteredTreeBuilder::setDirectoriesOnly(bool directoriesOnly) {
 
 void FilteredTreeBuilder::clearFilters() {
     filters_.clear();
+    nameMatcher_.clear();
+    directoryMatcher_.clear();
 }
 
 void FilteredTreeBuilder::buildTree(bool showHidden) {
@@ -100,74 +148,70 @@ void FilteredTreeBuilder::buildTree(bool showHidden) {
     stats_ = Statistics{0, 0, 0};
     displayStats_ = DisplayStatistics{};
     currentDepth_ = 0;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+    
+    renderer_.clear();
+    emitLine(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
     
-    treeLines_.push_back(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+    traverseDirectory(rootPath_, true, showHidden, true);
     
-    traverseDirectory(rootPath_, "", true, showHidden, true);
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
 }
 
-bool FilteredTreeBuilder::shouldIncludeEntry(const fs::path& path, const FileSystem::FileInfo& info) const {
+bool FilteredTreeBuilder::shouldIncludeEntry(std::string_view name, const FileSystem::RawMetadata& meta) const {
+    bool isDirectory = S_ISDIR(meta.mode);
     // Если включен режим "только директории", исключаем файлы
-    if (directoriesOnly_ && !info.isDirectory) {
+    if (directoriesOnly_ && !isDirectory) {
         return false;
     }
 
     // Если фильтров нет, включаем все
-    if (filters_.empty()) {
+    if (!hasFilters()) {
         return true;
     }
 
     // Для директорий всегда возвращаем true (чтобы можно было их обходить)
-    if (info.isDirectory) {
+    if (isDirectory) {
         return true;
     }
 
     // Для файлов применяем все фильтры
-    return matchesAllFilters(info);
+    return matchesAllFilters(name, meta);
 }
 
-bool FilteredTreeBuilder::matchesAllFilters(const FileSystem::FileInfo& info) const {
-    if (filters_.empty()) {
+bool FilteredTreeBuilder::matchesAllFilters(std::string_view name, const FileSystem::RawMetadata& meta) const {
+    if (!hasFilters()) {
         return true; 
     }
     
+    return matchesNameFilters(name) && matchesMetadataFilters(meta);
+}
+
+bool FilteredTreeBuilder::matchesMetadataFilters(const FileSystem::RawMetadata& meta) const {
     for (const auto& filter : filters_) {
-        if (!matchesSingleFilter(info, filter)) {
+        if (!matchesSingleFilter(meta, filter)) {
             return false;
         }
     }
     return true;
 }
 
-bool FilteredTreeBuilder::matchesSingleFilter(const FileSystem::FileInfo& info, const Filter& filter) const {
+bool FilteredTreeBuilder::matchesSingleFilter(const FileSystem::RawMetadata& meta, const Filter& filter) const {
     switch (filter.type) {
-        case Filter::Type::SIZE:
-            if (filter.operation == ">") return info.size > filter.sizeValue;
-            else if (filter.operation == "<") return info.size < filter.sizeValue;
-            else if (filter.operation == "==") return info.size == filter.sizeValue;
-            else if (filter.operation == ">=") return info.size >= filter.sizeValue;
-            else if (filter.operation == "<=") return info.size <= filter.sizeValue;
-            break;
-            
-        case Filter::Type::DATE: {
-            std::tm tm = {};
-            std::istringstream ss(info.lastModified);
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-            if (!ss.fail()) {
-                std::time_t tt = std::mktime(&tm);
-                auto fileTime = std::chrono::system_clock::from_time_t(tt);
-                
-                if (filter.operation == ">") return fileTime > filter.dateValue;
-                else if (filter.operation == "<") return fileTime < filter.dateValue;
-                else if (filter.operation == "==") return fileTime == filter.dateValue;
-            }
+        case Filter::Type::SIZE: {
+            // Без метаданных (нет прав, битая ссылка) размер считается нулевым
+            uint64_t size = meta.mode == 0 ? 0 : meta.size;
+            if (filter.operation == ">") return size > filter.sizeValue;
+            else if (filter.operation == "<") return size < filter.sizeValue;
+            else if (filter.operation == "==") return size == filter.sizeValue;
+            else if (filter.operation == ">=") return size >= filter.sizeValue;
+            else if (filter.operation == "<=") return size <= filter.sizeValue;
             break;
         }
             
-        case Filter::Type::NAME: {
-            bool matches = std::regex_match(info.name, filter.namePattern);
-            return filter.include ? matches : !matches;
-        }
+        case Filter::Type::DATE:
+            // Диапазон вычислен при добавлении фильтра; без метаданных элемент не отсекается
+            return meta.mode == 0 || (meta.mtimeNs >= filter.minTimeNs && meta.mtimeNs < filter.maxTimeNs);
             
         default: break;
     }
@@ -175,103 +219,110 @@ bool FilteredTreeBuilder::matchesSingleFilter(const FileSystem::FileInfo& info,
     return true;
 }
 
-void FilteredTreeBuilder::traverseDirectory(const fs::path& path, 
-                                          const std::string& prefix, 
-                                          bool isLast,
-                                          bool showHidden,
-                                          bool isRoot) {
-    if (maxDepth_ > 0 && currentDepth_ >= maxDepth_) {
-        if (!isRoot) {
-            displayStats_.hiddenByDepth++;
-        }
-        return;
-    }
-    
-    // Всегда показываем корневую директорию
+uint64_t FilteredTreeBuilder::traverseDirectory(const fs::path& path, 
+                                              bool isLast,
+                                              bool showHidden,
+                                              bool isRoot) {
+    // Строка корня уже выведена в buildTree; строки остальных директорий
+    // выводит родитель, с метаданными из общей пачки
     if (!isRoot) {
-        auto info = FileSystem::getFileInfo(path);
-        if (shouldIncludeEntry(path, info)) {
-            std::string connector = isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-            treeLines_.push_back(prefix + connector + formatTreeLine(info, connector));
+        FileSystem::RawMetadata meta;
+        bool isSymlink = false;
+        FileSystem::resolveMetadata(path, meta, isSymlink);
+        std::string_view name = FileSystem::fileName(path);
+        if (shouldIncludeEntry(name, meta)) {
+            renderEntryLine(name, meta, isSymlink, isLast);
+            emitLine(renderer_.line());
             stats_.totalDirectories++;
             displayStats_.displayedDirectories++;
         }
     }
-    
-    currentDepth_++;
-    
-    std::string newPrefix = prefix;
-    if (isLast) {
-        newPrefix += constants::TREE_SPACE;
-    } else {
-        newPrefix += constants::TREE_VERTICAL;
+    return scanDirectory(path, isLast, showHidden);
+}
+
+uint64_t FilteredTreeBuilder::scanDirectory(const fs::path& path, bool isLast, bool showHidden) {
+    std::vector<DirEntry> entries;
+    if (!listDirectory(path, showHidden, entries)) {
+        return 0;
     }
     
-    std::vector<fs::directory_entry> entries;
+    // Все решения, для которых хватает имени и d_type, принимаются до stat:
+    // файлы - по шаблонам имени и -D, директории - по шаблонам директорий.
+    // Исключенная директория не открывается; директория за границей глубины
+    // не выводится и не читается, но, как и раньше, занимает место среди соседей
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [this](const DirEntry& entry) {
+        if (entry.isDirectory) {
+            return !directoryMatcher_.matches(entry.name);
+        }
+        return directoriesOnly_ || !matchesNameFilters(entry.name);
+    }), entries.end());
+    sortEntries(entries);
     
-    try {
-        for (const auto& entry : fs::directory_iterator(path)) {
-            bool isHidden = FileSystem::isHidden(entry.path());
-            
-            if (!isHidden || showHidden) {
-                entries.push_back(entry);
-            } else {
-                hiddenObjectsCount_++;
-            }
+    bool depthReached = maxDepth_ > 0 && currentDepth_ + 1 >= maxDepth_;
+    
+    // Метаданные выводимых элементов - одной пачкой
+    std::vector<const fs::path*> paths;
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!entries[i].isDirectory || !depthReached) {
+            paths.push_back(&entries[i].path);
+            indices.push_back(i);
         }
-    } catch (const fs::filesystem_error&) {
-        currentDepth_--;
-        return;
+    }
+    std::vector<FileSystem::RawMetadata> batchMetas;
+    std::vector<char> batchSymlinks;
+    FileSystem::resolveMetadataBatch(paths, batchMetas, batchSymlinks);
+    std::vector<FileSystem::RawMetadata> metas(entries.size());
+    std::vector<char> symlinks(entries.size(), 0);
+    for (size_t k = 0; k < indices.size(); ++k) {
+        metas[indices[k]] = batchMetas[k];
+        symlinks[indices[k]] = batchSymlinks[k];
     }
     
-    // Фильтрация записей перед сортировкой и отображением
-    std::vector<fs::directory_entry> filteredEntries;
-    for (const auto& entry : entries) {
-        auto info = FileSystem::getFileInfo(entry.path());
-        if (shouldIncludeEntry(entry.path(), info)) {
-            filteredEntries.push_back(entry);
+    // Фильтры по метаданным - по сырым значениям, строки тоже собираются из них
+    std::vector<size_t> shown;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].isDirectory || matchesMetadataFilters(metas[i])) {
+            shown.push_back(i);
         }
     }
     
-    std::sort(filteredEntries.begin(), filteredEntries.end(), [](const auto& a, const auto& b) {
-        if (a.is_directory() != b.is_directory()) {
-            return a.is_directory() > b.is_directory();
-        }
-        return a.path().filename().string() < b.path().filename().string();
-    });
+    uint64_t subtreeSize = 0;
+    currentDepth_++;
+    renderer_.pushLevel(isLast);
     
-    for (size_t i = 0; i < filteredEntries.size(); ++i) {
-        const auto& entry = filteredEntries[i];
-        bool entryIsLast = (i == filteredEntries.size() - 1);
-        auto info = FileSystem::getFileInfo(entry.path());
+    for (size_t k = 0; k < shown.size(); ++k) {
+        const auto& entry = entries[shown[k]];
+        bool entryIsLast = (k == shown.size() - 1);
+        
+        if (entry.isDirectory && depthReached) {
+            displayStats_.hiddenByDepth++;
+            continue;
+        }
+        const auto& meta = metas[shown[k]];
+        bool isSymlink = symlinks[shown[k]] != 0;
         
-        if (entry.is_directory()) {
-            traverseDirectory(entry.path(), newPrefix, entryIsLast, showHidden, false);
+        if (entry.isDirectory) {
+            if (shouldIncludeEntry(entry.name, meta)) {
+                renderEntryLine(entry.name, meta, isSymlink, entryIsLast);
+                emitLine(renderer_.line());
+                stats_.totalDirectories++;
+                displayStats_.displayedDirectories++;
+            }
+            subtreeSize += scanDirectory(entry.path, entryIsLast, showHidden);
         } else {
-            std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-            treeLines_.push_back(newPrefix + connector + formatTreeLine(info, connector));
+            uint64_t size = FileSystem::entrySize(meta);
+            renderEntryLine(entry.name, meta, isSymlink, entryIsLast);
+            emitLine(renderer_.line());
             stats_.totalFiles++;
-            stats_.totalSize += info.size;
+            stats_.totalSize += size;
             displayStats_.displayedFiles++;
-            displayStats_.displayedSize += info.size;
+            displayStats_.displayedSize += size;
+            subtreeSize += size;
         }
     }
     
+    renderer_.popLevel();
     currentDepth_--;
+    return subtreeSize;
 }
-
-std::string FilteredTreeBuilder::formatTreeLine(const FileSystem::FileInfo& info, 
-                                              const std::string& connector) const {
-    std::string nameColor = FileSystem::getFileColor(info);  
-    if (info.isDirectory) {
-        return nameColor + info.name + ColorManager::getReset() + " " + 
-               ColorManager::getDirLabelColor() + "[DIR]" + ColorManager::getReset() + " | " + 
-               ColorManager::getDateColor() + info.lastModified + ColorManager::getReset() + " | " + 
-               ColorManager::getPermissionsColor() + info.permissions + ColorManager::getReset();
-    } else {
-        return nameColor + info.name + ColorManager::getReset() + " (" + 
-               ColorManager::getSizeColor() + info.sizeFormatted + ColorManager::getReset() + ") | " + 
-               ColorManager::getDateColor() + info.lastModified + ColorManager::getReset() + " | " + 
-               ColorManager::getPermissionsColor() + info.permissions + ColorManager::getReset();
-    }
-}
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 #include "TreeBuilder.h"
+#include "GlobMatcher.h"
 #include <string>
-#include <regex>
+#include <iostream>
 #include <chrono>
+#include <limits>
 #include <vector>
 
 class FilteredTreeBuilder : public TreeBuilder {
@@ -10,39 +12,61 @@ public:
     explicit FilteredTreeBuilder(const std::string& rootPath);
     
     void addSizeFilter(uint64_t size, const std::string& operation = ">");
+    // date - "YYYY-MM-DD", "YYYY-MM-DD HH:MM:SS" или возраст "30s", "15m", "12h", "7d", "2w";
+    // для возраста сравнивается он сам: "< 7d" - изменены за последние 7 дней
     void addDateFilter(const std::string& date, const std::string& operation = ">");
+    // Шаблоны включения объединяются по "или", исключения проверяются все.
+    // Шаблон исключения с / на конце ("build/") относится к директориям:
+    // такие директории не выводятся и не открываются
     void addNameFilter(const std::string& pattern, bool include = true);
     void setMaxDepth(size_t maxDepth);
     void setDirectoriesOnly(bool directoriesOnly);
     void clearFilters();
+    // Куда писать сообщения о добавленных фильтрах (при выводе JSON - в stderr)
+    void setLog(std::ostream& log) { log_ = &log; }
     
     void buildTree(bool showHidden = false) override;
     
-private:
+protected:
     struct Filter {
-        enum class Type { NONE, SIZE, DATE, NAME } type = Type::NONE;
+        enum class Type { NONE, SIZE, DATE } type = Type::NONE;
         std::string operation;
         uint64_t sizeValue = 0;
-        std::chrono::system_clock::time_point dateValue;
-        std::regex namePattern;
-        bool include = true;
+        // Подходящие mtime (нс от эпохи): [minTimeNs, maxTimeNs)
+        int64_t minTimeNs = std::numeric_limits<int64_t>::min();
+        int64_t maxTimeNs = std::numeric_limits<int64_t>::max();
         bool directoriesOnly_ = false;
     };
     
+    // Фильтры по метаданным; шаблоны имен файлов - в nameMatcher_, директорий - в directoryMatcher_
     std::vector<Filter> filters_;
+    GlobMatcher nameMatcher_;
+    GlobMatcher directoryMatcher_;
     size_t maxDepth_;
     size_t currentDepth_;
     bool directoriesOnly_ = false;
+    std::ostream* log_ = &std::cout;
+    
+    bool hasFilters() const { return !filters_.empty() || !nameMatcher_.empty() || !directoryMatcher_.empty(); }
+    bool matchesNameFilters(std::string_view name) const { return nameMatcher_.matches(name); }
+    bool matchesMetadataFilters(const FileSystem::RawMetadata& meta) const;
+    
+private:
+    uint64_t traverseDirectory(const std::filesystem::path& path, 
+                              bool isLast,
+                              bool showHidden,
+                              bool isRoot = false) override;
+    // Содержимое директории, строка которой уже выведена
+    uint64_t scanDirectory(const std::filesystem::path& path, bool isLast, bool showHidden);
+    
+    bool shouldIncludeEntry(std::string_view name, const FileSystem::RawMetadata& meta) const;
+    bool matchesAllFilters(std::string_view name, const FileSystem::RawMetadata& meta) const;
+    bool matchesSingleFilter(const FileSystem::RawMetadata& meta, const Filter& filter) const;
     
-    void traverseDirectory(const std::filesystem::path& path, 
-                          const std::string& prefix, 
-                          bool isLast,
-                          bool showHidden,
-                          bool isRoot = false) override;
-    
-    bool shouldIncludeEntry(const std::filesystem::path& path, const FileSystem::FileInfo& info) const;
-    bool matchesAllFilters(const FileSystem::FileInfo& info) const;
-    bool matchesSingleFilter(const FileSystem::FileInfo& info, const Filter& filter) const;
-    std::string wildcardToRegex(const std::string& pattern) const;
-    std::string formatTreeLine(const FileSystem::FileInfo& info, const std::string& connector) const override;
+    // "7d" - возраст и длина единицы; false - не относительная форма
+    static bool parseAge(const std::string& text, int64_t& ageNs, int64_t& unitNs);
+    // Местное время: начало и конец указанных суток или секунды
+    static bool parseLocalTime(const std::string& text, int64_t& startNs, int64_t& endNs);
+    // Операция над интервалом [startNs, endNs) в диапазон mtime фильтра
+    static void setTimeRange(Filter& filter, const std::string& operation, int64_t startNs, int64_t endNs);
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "GitHubTreeBuilder.h"
 #include "ColorManager.h"
+#include "FileColorTable.h"
 #include "Constants.h"
 #include <iostream>
 #include <sstream>
@@ -35,23 +36,23 @@ void GitHubTreeBuilder::buildTree(bool showHidden) {
     displayStats_ = DisplayStatistics{};
     
     if (!isValid_) {
-        treeLines_.push_back("Ошибка: неверный URL GitHub репозитория");
+        emitLine("Ошибка: неверный URL GitHub репозитория");
         return;
     }
     
-    treeLines_.push_back(ColorManager::getDirNameColor() + "[GITHUB] " + 
+    emitLine(ColorManager::getDirNameColor() + "[GITHUB] " + 
                         user_ + "/" + repo_ + " (" + branch_ + ")" + 
                         ColorManager::getReset());
     
     try {
         auto rootEntries = getGitHubTree(basePath_);
         if (rootEntries.empty()) {
-            treeLines_.push_back("  └── (репозиторий пуст или недоступен)");
+            emitLine("  └── (репозиторий пуст или недоступен)");
         } else {
             traverseGitHubTree(rootEntries, "", true, 1);
         }
     } catch (const std::exception& e) {
-        treeLines_.push_back("  └── Ошибка: " + std::string(e.what()));
+        emitLine("  └── Ошибка: " + std::string(e.what()));
     }
 }
 
@@ -97,7 +98,11 @@ std::vector<GitHubTreeBuilder::GitHubFileInfo> GitHubTreeBuilder::getGitHubTree(
     curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response);
     
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res;
+    {
+        Profiler::Scope scope(Profiler::Phase::NETWORK);
+        res = curl_easy_perform(curl_);
+    }
     
     if (res != CURLE_OK) {
         return result;
@@ -158,7 +163,11 @@ std::string GitHubTreeBuilder::getLastCommitTime(const std::string& path) {
     curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, WriteCallback);
     curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &response);
     
-    CURLcode res = curl_easy_perform(curl_);
+    CURLcode res;
+    {
+        Profiler::Scope scope(Profiler::Phase::NETWORK);
+        res = curl_easy_perform(curl_);
+    }
     
     if (res != CURLE_OK) {
         return "N/A";
@@ -233,7 +242,7 @@ void GitHubTreeBuilder::traverseGitHubTree(const std::vector<GitHubFileInfo>& en
                                          size_t currentDepth) {
     if (currentDepth > maxDepth_ + 2) {
         std::string connector = isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-        treeLines_.push_back(prefix + connector + "(глубина ограничена)");
+        emitLine(prefix + connector + "(глубина ограничена)");
         return;
     }
     
@@ -249,7 +258,7 @@ void GitHubTreeBuilder::traverseGitHubTree(const std::vector<GitHubFileInfo>& en
         bool entryIsLast = (i == entries.size() - 1);
         
         std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-        treeLines_.push_back(prefix + connector + formatTreeLine(entry, connector));
+        emitLine(prefix + connector + formatTreeLine(entry, connector));
         
         if (entry.type == "dir") {
             stats_.totalDirectories++;
@@ -273,6 +282,7 @@ void GitHubTreeBuilder::traverseGitHubTree(const std::vector<GitHubFileInfo>& en
 
 std::string GitHubTreeBuilder::formatTreeLine(const GitHubFileInfo& info, const std::string& connector) const {
     (void)connector;
+    Profiler::Scope scope(Profiler::Phase::FORMAT);
     
     const bool colorsEnabled = ColorManager::areColorsEnabled();
     std::stringstream line;
@@ -281,27 +291,7 @@ std::string GitHubTreeBuilder::formatTreeLine(const GitHubFileInfo& info, const
         if (info.type == "dir") {
             line << ColorManager::getDirNameColor();
         } else {
-            std::string ext = "";
-            size_t dotPos = info.name.find_last_of(".");
-            if (dotPos != std::string::npos && dotPos < info.name.length() - 1) {
-                ext = info.name.substr(dotPos + 1);
-                std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-            }
-            
-            if (ext == "cpp" || ext == "h" || ext == "hpp" || ext == "c" || 
-                ext == "java" || ext == "py" || ext == "js" || ext == "ts") {
-                line << constants::CODE_COLOR;
-            } else if (ext == "md" || ext == "txt" || ext == "pdf") {
-                line << constants::DOCUMENT_COLOR;
-            } else if (ext == "json" || ext == "yml" || ext == "yaml" || ext == "xml") {
-                line << constants::CONFIG_COLOR;
-            } else if (ext == "jpg" || ext == "png" || ext == "gif" || ext == "svg") {
-                line << constants::IMAGE_COLOR;
-            } else if (ext == "zip" || ext == "rar" || ext == "tar" || ext == "gz") {
-                line << constants::ARCHIVE_COLOR;
-            } else {
-                line << constants::WHITE;
-            }
+            line << FileColorTable::forFileName(info.name);
         }
     }
     
@@ -19,8 +19,6 @@ public:
     bool isValid() const { return isValid_; }
     void setMaxDepth(size_t maxDepth) { maxDepth_ = maxDepth; }
 
-    using TreeBuilder::formatTreeLine;
-
 private:
     struct GitHubFileInfo {
         std::string path;
@@ -2,117 +2,110 @@
 #include "ColorManager.h"
 #include "Constants.h"
 #include <iostream>
+#include <sstream>
 #include <algorithm>
 
 namespace fs = std::filesystem;
 
-JSONTreeBuilder::JSONTreeBuilder(const std::string& rootPath) 
+JSONTreeBuilder::JSONTreeBuilder(const std::string& rootPath)
     : TreeBuilder(rootPath) {}
 
 void JSONTreeBuilder::buildTree(bool showHidden) {
     treeLines_.clear();
+    json_.clear();
     stats_ = Statistics{0, 0, 0};
     displayStats_ = DisplayStatistics{};
     hiddenObjectsCount_ = 0;
-    
-    // Строим JSON структуру
-    jsonData_ = traverseDirectoryJSON(rootPath_, showHidden, true);
-    
-    // Добавляем статистику в корень JSON
-    jsonData_["statistics"] = {
-        {"directories", stats_.totalDirectories},
-        {"files", stats_.totalFiles},
-        {"totalSize", stats_.totalSize},
-        {"totalSizeFormatted", FileSystem::formatSize(stats_.totalSize)}
-    };
-    
+    ignoredObjectsCount_ = 0;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+
+    std::ostringstream buffer;
+    std::unique_ptr<JSONWriter> ownWriter;
+    JSONWriter* writer = writer_;
+    if (!writer) {
+        ownWriter = std::make_unique<JSONWriter>(buffer);
+        writer = ownWriter.get();
+    }
+
+    // Статистика в корне идет после "contents", когда обход уже закончен
+    writer->beginObject();
+    bool readable = true;
+    writeContents(*writer, rootPath_, showHidden, readable);
+    {
+        Profiler::Scope scope(Profiler::Phase::JSON);
+        JSONTreeRenderer::writeRootFields(*writer, rootPath_.string(),
+                                          readable ? nullptr : JSONTreeRenderer::READ_ERROR, stats_);
+        writer->endObject();
+    }
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
+
+    if (ownWriter) {
+        ownWriter->finish();
+        json_ = buffer.str();
+    }
+
     // Для обратной совместимости создаем текстовое представление
     treeLines_.push_back("JSON output available - use getJSON() method");
 }
 
 void JSONTreeBuilder::printTree() const {
-    std::cout << jsonData_.dump(2) << std::endl;
+    Profiler::Scope scope(Profiler::Phase::OUTPUT);
+    std::cout << json_ << std::endl;
 }
 
 std::string JSONTreeBuilder::getJSON() const {
-    return jsonData_.dump(2);
+    return json_;
 }
 
-json JSONTreeBuilder::traverseDirectoryJSON(const fs::path& path, 
-                                          bool showHidden,
-                                          bool isRoot) {
-    json node;
-    
-    if (isRoot) {
-        node["path"] = path.string();
-        node["name"] = "";
-        node["type"] = "directory";
-    } else {
-        auto info = FileSystem::getFileInfo(path);
-        node = fileInfoToJSON(info);
-        stats_.totalDirectories++;
-        displayStats_.displayedDirectories++;
+uint64_t JSONTreeBuilder::writeContents(JSONWriter& writer, const fs::path& path,
+                                        bool showHidden, bool& readable) {
+    std::vector<DirEntry> entries;
+    if (!listDirectory(path, showHidden, entries)) {
+        readable = false;
+        return 0;
     }
-    
-    std::vector<fs::directory_entry> entries;
-    json contents = json::array();
-    
-    try {
-        for (const auto& entry : fs::directory_iterator(path)) {
-            bool isHidden = FileSystem::isHidden(entry.path());
-            
-            if (!isHidden || showHidden) {
-                entries.push_back(entry);
-            } else {
-                hiddenObjectsCount_++;
-            }
-        }
-    } catch (const fs::filesystem_error&) {
-        node["error"] = "Permission denied";
-        return node;
+
+    sortEntries(entries);
+    if (entries.empty()) {
+        return 0;
     }
-    
-    // Сортировка: сначала директории, потом файлы
-    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
-        if (a.is_directory() != b.is_directory()) {
-            return a.is_directory() > b.is_directory();
-        }
-        return a.path().filename().string() < b.path().filename().string();
-    });
-    
-    for (const auto& entry : entries) {
-        if (entry.is_directory()) {
-            // РЕКУРСИВНЫЙ ОБХОД для директорий
-            json childNode = traverseDirectoryJSON(entry.path(), showHidden, false);
-            contents.push_back(childNode);
+
+    // Фаза исключительная: чтение каталогов и stat внутри учитываются отдельно
+    Profiler::Scope scope(Profiler::Phase::JSON);
+    writer.key("contents");
+    writer.beginArray();
+
+    uint64_t subtreeSize = 0;
+    MetadataBatch metas(entries);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        writer.beginObject();
+        // В JSON попадают отформатированные поля, так что FileInfo здесь нужен
+        const auto& meta = metas.at(i);
+        auto info = FileSystem::makeFileInfo(entries[i].name, meta, metas.isSymlink(i));
+        if (entries[i].isDirectory) {
+            // Размер директории заменяется суммой содержимого
+            stats_.totalDirectories++;
+            displayStats_.displayedDirectories++;
+
+            bool childReadable = true;
+            uint64_t size = writeContents(writer, entries[i].path, showHidden, childReadable);
+            info.size = size;
+            info.sizeFormatted = FileSystem::formatSize(size);
+            JSONTreeRenderer::writeEntryFields(writer, info,
+                                               childReadable ? nullptr : JSONTreeRenderer::READ_ERROR);
+            subtreeSize += size;
         } else {
-            auto info = FileSystem::getFileInfo(entry.path());
-            contents.push_back(fileInfoToJSON(info));
-            
+            JSONTreeRenderer::writeEntryFields(writer, info, nullptr);
+            subtreeSize += info.size;
+
             stats_.totalFiles++;
             stats_.totalSize += info.size;
             displayStats_.displayedFiles++;
             displayStats_.displayedSize += info.size;
         }
+        writer.endObject();
     }
-    
-    if (!contents.empty()) {
-        node["contents"] = contents;
-    }
-    
-    return node;
-}
 
-json JSONTreeBuilder::fileInfoToJSON(const FileSystem::FileInfo& info) {
-    return {
-        {"name", info.name},
-        {"type", info.isDirectory ? "directory" : "file"},
-        {"size", info.size},
-        {"sizeFormatted", info.sizeFormatted},
-        {"lastModified", info.lastModified},
-        {"permissions", info.permissions},
-        {"isHidden", info.isHidden},
-        {"isExecutable", info.isExecutable},
-        {"isSymlink", info.isSymlink}
-    };
-}
\ No newline at end of file
+    writer.endArray();
+    return subtreeSize;
+}
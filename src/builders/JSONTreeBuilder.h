@@ -1,22 +1,28 @@
 #pragma once
 #include "TreeBuilder.h"
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
+#include "JSONTreeRenderer.h"
 
+// JSON пишется во время обхода: элемент выводится, как только прочитан
+// его каталог, и в памяти остаются только записи текущего пути
 class JSONTreeBuilder : public TreeBuilder {
 public:
     explicit JSONTreeBuilder(const std::string& rootPath);
-    
+
     void buildTree(bool showHidden = false) override;
     void printTree() const override;
+    // JSON последнего buildTree, если он строился без writer
     std::string getJSON() const;
-    
+
+    // Куда buildTree пишет документ; без writer (nullptr) JSON
+    // собирается в строку для getJSON()
+    void setJSONWriter(JSONWriter* writer) { writer_ = writer; }
+
 private:
-    json jsonData_;
-    
-    json traverseDirectoryJSON(const std::filesystem::path& path, 
-                             bool showHidden,
-                             bool isRoot = false);
-    json fileInfoToJSON(const FileSystem::FileInfo& info);
-};
\ No newline at end of file
+    JSONWriter* writer_ = nullptr;
+    std::string json_;
+
+    // "contents" директории; возвращает суммарный размер поддерева,
+    // readable - удалось ли прочитать каталог
+    uint64_t writeContents(JSONWriter& writer, const std::filesystem::path& path,
+                           bool showHidden, bool& readable);
+};
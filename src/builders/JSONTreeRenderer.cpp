@@ -0,0 +1,110 @@
+#include "JSONTreeRenderer.h"
+
+void JSONTreeRenderer::render(JSONWriter& writer, const TreeModel& model, const TreeView& view,
+                              const std::string& rootPath, const TreeBuilder::Statistics& stats) {
+    if (model.empty()) {
+        writer.null();
+        return;
+    }
+
+    writer.beginObject();
+    uint64_t size = 0;
+    renderContents(writer, model, view, TreeModel::ROOT, size);
+    writeRootFields(writer, rootPath, model.isUnreadable(TreeModel::ROOT) ? READ_ERROR : nullptr, stats);
+    writer.endObject();
+}
+
+uint64_t JSONTreeRenderer::renderNode(JSONWriter& writer, const TreeModel& model, const TreeView& view,
+                                      TreeModel::Index node) {
+    writer.beginObject();
+    auto info = model.entryInfo(node);
+    uint64_t size = info.size;
+    const char* error = nullptr;
+    if (model.isDirectory(node)) {
+        size = 0;
+        renderContents(writer, model, view, node, size);
+        error = model.isUnreadable(node) ? READ_ERROR : nullptr;
+        // Размер директории - сумма показанного поддерева
+        info.size = size;
+        info.sizeFormatted = FileSystem::formatSize(size);
+    }
+    writeEntryFields(writer, info, error);
+    writer.endObject();
+    return size;
+}
+
+void JSONTreeRenderer::renderContents(JSONWriter& writer, const TreeModel& model, const TreeView& view,
+                                      TreeModel::Index node, uint64_t& size) {
+    if (model.isUnreadable(node) || view.state(node) != TreeView::State::SHOWN) {
+        return;
+    }
+
+    bool opened = false;
+    TreeModel::Index first = model.firstChild(node);
+    for (TreeModel::Index child = first; child < first + model.childCount(node); ++child) {
+        TreeView::State state = view.state(child);
+        if (state == TreeView::State::HIDDEN || state == TreeView::State::PLACEHOLDER) {
+            continue;
+        }
+        if (!opened) {
+            writer.key("contents");
+            writer.beginArray();
+            opened = true;
+        }
+        size += renderNode(writer, model, view, child);
+    }
+    if (opened) {
+        writer.endArray();
+    }
+}
+
+void JSONTreeRenderer::writeEntryFields(JSONWriter& writer, const FileSystem::FileInfo& info,
+                                        const char* error) {
+    if (error) {
+        writer.key("error");
+        writer.value(error);
+    }
+    writer.key("isExecutable");
+    writer.value(info.isExecutable);
+    writer.key("isHidden");
+    writer.value(info.isHidden);
+    writer.key("isSymlink");
+    writer.value(info.isSymlink);
+    writer.key("lastModified");
+    writer.value(info.lastModified);
+    writer.key("name");
+    writer.value(info.name);
+    writer.key("permissions");
+    writer.value(info.permissions);
+    writer.key("size");
+    writer.value(static_cast<uint64_t>(info.size));
+    writer.key("sizeFormatted");
+    writer.value(info.sizeFormatted);
+    writer.key("type");
+    writer.value(info.isDirectory ? "directory" : "file");
+}
+
+void JSONTreeRenderer::writeRootFields(JSONWriter& writer, const std::string& rootPath,
+                                       const char* error, const TreeBuilder::Statistics& stats) {
+    if (error) {
+        writer.key("error");
+        writer.value(error);
+    }
+    writer.key("name");
+    writer.value("");
+    writer.key("path");
+    writer.value(rootPath);
+    writer.key("statistics");
+    writer.beginObject();
+    writer.key("directories");
+    writer.value(static_cast<uint64_t>(stats.totalDirectories));
+    writer.key("files");
+    writer.value(static_cast<uint64_t>(stats.totalFiles));
+    writer.key("totalSize");
+    writer.value(stats.totalSize);
+    writer.key("totalSizeFormatted");
+    writer.value(FileSystem::formatSize(stats.totalSize));
+    writer.endObject();
+    writer.key("type");
+    writer.value("directory");
+}
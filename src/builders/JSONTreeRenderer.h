@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include "TreeBuilder.h"
+#include "TreeView.h"
+#include "JSONWriter.h"
+
+// JSON дерева (формат --json). Узлы пишутся в JSONWriter сразу, без DOM.
+// Ключи идут по алфавиту, поэтому "contents" - первым, а размер
+// директории (сумма содержимого) - после него: обход может писать
+// элементы по мере чтения каталогов.
+class JSONTreeRenderer {
+public:
+    // Документ целиком по модели и виду; поля форматируются только
+    // для узлов, попавших в вид
+    static void render(JSONWriter& writer, const TreeModel& model, const TreeView& view,
+                       const std::string& rootPath, const TreeBuilder::Statistics& stats);
+
+    // Поля после "contents" для обхода, пишущего JSON сам.
+    // error - текст ошибки чтения директории или nullptr
+    static void writeEntryFields(JSONWriter& writer, const FileSystem::FileInfo& info,
+                                 const char* error);
+    static void writeRootFields(JSONWriter& writer, const std::string& rootPath,
+                                const char* error, const TreeBuilder::Statistics& stats);
+
+    static constexpr const char* READ_ERROR = "Permission denied";
+
+private:
+    // Возвращает суммарный размер показанных файлов поддерева
+    static uint64_t renderNode(JSONWriter& writer, const TreeModel& model, const TreeView& view,
+                               TreeModel::Index node);
+    // "contents" узла; size - сумма показанного содержимого
+    static void renderContents(JSONWriter& writer, const TreeModel& model, const TreeView& view,
+                               TreeModel::Index node, uint64_t& size);
+};
@@ -0,0 +1,196 @@
+#include "JSONWriter.h"
+#include "Profiler.h"
+#include <charconv>
+
+namespace {
+    // Длина корректной UTF-8 последовательности, начинающейся с text[i], или 0
+    size_t utf8SequenceLength(std::string_view text, size_t i) {
+        auto byte = [&text](size_t index) { return static_cast<unsigned char>(text[index]); };
+        auto inRange = [&](size_t index, unsigned char low, unsigned char high) {
+            return index < text.size() && byte(index) >= low && byte(index) <= high;
+        };
+
+        unsigned char lead = byte(i);
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            return inRange(i + 1, 0x80, 0xBF) ? 2 : 0;
+        }
+        if (lead >= 0xE0 && lead <= 0xEF) {
+            // Без overlong-форм и суррогатов
+            unsigned char low = lead == 0xE0 ? 0xA0 : 0x80;
+            unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+            return inRange(i + 1, low, high) && inRange(i + 2, 0x80, 0xBF) ? 3 : 0;
+        }
+        if (lead >= 0xF0 && lead <= 0xF4) {
+            unsigned char low = lead == 0xF0 ? 0x90 : 0x80;
+            unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+            return inRange(i + 1, low, high) && inRange(i + 2, 0x80, 0xBF) &&
+                   inRange(i + 3, 0x80, 0xBF) ? 4 : 0;
+        }
+        return 0;
+    }
+}
+
+JSONWriter::JSONWriter(std::ostream& out, bool compact)
+    : out_(out), compact_(compact) {
+    buffer_.reserve(FLUSH_THRESHOLD + 4096);
+}
+
+JSONWriter::~JSONWriter() {
+    finish();
+}
+
+void JSONWriter::beginObject() {
+    beforeValue();
+    buffer_ += '{';
+    levels_.push_back(0);
+}
+
+void JSONWriter::endObject() {
+    size_t count = levels_.back();
+    levels_.pop_back();
+    if (count > 0) {
+        newline();
+    }
+    buffer_ += '}';
+    flushIfFull();
+}
+
+void JSONWriter::beginArray() {
+    beforeValue();
+    buffer_ += '[';
+    levels_.push_back(0);
+}
+
+void JSONWriter::endArray() {
+    size_t count = levels_.back();
+    levels_.pop_back();
+    if (count > 0) {
+        newline();
+    }
+    buffer_ += ']';
+    flushIfFull();
+}
+
+void JSONWriter::key(const std::string& name) {
+    beforeValue();
+    appendString(buffer_, name);
+    buffer_ += compact_ ? ":" : ": ";
+    afterKey_ = true;
+}
+
+void JSONWriter::value(const std::string& text) {
+    beforeValue();
+    appendString(buffer_, text);
+}
+
+void JSONWriter::value(const char* text) {
+    value(std::string(text));
+}
+
+void JSONWriter::value(uint64_t number) {
+    beforeValue();
+    char digits[20];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    buffer_.append(digits, result.ptr);
+}
+
+void JSONWriter::value(bool flag) {
+    beforeValue();
+    buffer_ += flag ? "true" : "false";
+}
+
+void JSONWriter::null() {
+    beforeValue();
+    buffer_ += "null";
+}
+
+void JSONWriter::finish() {
+    if (buffer_.empty()) {
+        return;
+    }
+    Profiler::Scope scope(Profiler::Phase::OUTPUT);
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    bytesWritten_ += buffer_.size();
+    buffer_.clear();
+}
+
+void JSONWriter::beforeValue() {
+    // Значение после ключа идет в той же строке
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (levels_.empty()) {
+        return;
+    }
+    if (levels_.back()++ > 0) {
+        buffer_ += ',';
+    }
+    newline();
+}
+
+void JSONWriter::newline() {
+    if (!compact_) {
+        buffer_ += '\n';
+        buffer_.append(levels_.size() * 2, ' ');
+    }
+}
+
+void JSONWriter::appendString(std::string& out, std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+
+    out += '"';
+    size_t i = 0;
+    while (i < text.size()) {
+        // Обычные ASCII-символы копируются отрезками
+        size_t start = i;
+        while (i < text.size()) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c < 0x20 || c == '"' || c == '\\' || c >= 0x80) {
+                break;
+            }
+            ++i;
+        }
+        out.append(text, start, i - start);
+        if (i == text.size()) {
+            break;
+        }
+
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(text, i);
+            if (length == 0) {
+                // Имя файла не обязано быть UTF-8: байт заменяется на U+FFFD
+                out += "\xEF\xBF\xBD";
+                ++i;
+            } else {
+                out.append(text, i, length);
+                i += length;
+            }
+            continue;
+        }
+
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0x0F];
+                break;
+        }
+        ++i;
+    }
+    out += '"';
+}
+
+void JSONWriter::flushIfFull() {
+    if (buffer_.size() >= FLUSH_THRESHOLD) {
+        finish();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Потоковая запись JSON (в духе SAX): значения пишутся в поток по мере
+// вызовов, в памяти - только буфер и стек уровней вложенности.
+// Формат совпадает с nlohmann::json::dump(2), в компактном режиме - с dump().
+// Порядок ключей задает вызывающий; для совместимости с прежним выводом
+// ключи объекта пишутся по алфавиту.
+class JSONWriter {
+public:
+    explicit JSONWriter(std::ostream& out, bool compact = false);
+    ~JSONWriter();
+
+    JSONWriter(const JSONWriter&) = delete;
+    JSONWriter& operator=(const JSONWriter&) = delete;
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(const std::string& name);
+
+    void value(const std::string& text);
+    void value(const char* text);
+    void value(uint64_t number);
+    void value(bool flag);
+    void null();
+
+    // Сбрасывает буфер в поток; перевод строки после документа - за вызывающим
+    void finish();
+    uint64_t bytesWritten() const { return bytesWritten_ + buffer_.size(); }
+
+    // Строка JSON в кавычках и с экранированием - в конец out
+    static void appendString(std::string& out, std::string_view text);
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::ostream& out_;
+    bool compact_;
+    std::string buffer_;
+    // Число уже записанных элементов на каждом открытом уровне
+    std::vector<size_t> levels_;
+    bool afterKey_ = false;
+    uint64_t bytesWritten_ = 0;
+
+    void beforeValue();
+    void newline();
+    void flushIfFull();
+};
@@ -0,0 +1,184 @@
+#include "ModelTreeBuilder.h"
+#include "JSONTreeRenderer.h"
+#include "TreeArchive.h"
+#include "TreeTextRenderer.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+ModelTreeBuilder::ModelTreeBuilder(const std::string& rootPath, size_t threadCount)
+    : FilteredTreeBuilder(rootPath), threadCount_(threadCount) {
+
+    if (threadCount_ == 0) {
+        unsigned int hwThreads = std::thread::hardware_concurrency();
+        threadCount_ = (hwThreads == 0) ? 2 : static_cast<size_t>(hwThreads);
+    }
+}
+
+void ModelTreeBuilder::buildTree(bool showHidden) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    treeLines_.clear();
+    stats_ = Statistics{0, 0, 0};
+    displayStats_ = DisplayStatistics{};
+    hiddenCount_ = 0;
+    ignoredCount_ = 0;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+
+    if (threadCount_ > 1) {
+        // Без текста основной вывод - JSON, и stdout занят им
+        (textOutput_ ? std::cout : std::cerr) << "Используется потоков: " << threadCount_ << std::endl;
+    }
+
+    TreeModel::Index root = model_.addRoot(rootPath_.string());
+    pool_ = std::make_unique<WorkStealingPool>(threadCount_);
+    pool_->submit([this, root, showHidden] {
+        scanDirectory(root, rootPath_, 0, showHidden);
+    });
+    pool_->wait();
+    pool_.reset();
+    model_.accumulateSizes();
+    hiddenObjectsCount_ = hiddenCount_.load();
+    ignoredObjectsCount_ = ignoredCount_.load();
+
+    // Фильтры по имени и -D уже применены при обходе; здесь - метаданные и глубина
+    bool filtering = hasFilters() || directoriesOnly_;
+    bool metadataFilters = !filters_.empty();
+    view_.states.assign(model_.size(), TreeView::State::HIDDEN);
+    view_.states[root] = TreeView::State::SHOWN;
+    buildView(root, 0, filtering, metadataFilters);
+
+    if (textOutput_) {
+        BufferSink buffer(treeLines_);
+        TreeTextRenderer::render(model_, view_, sink_ ? *sink_ : static_cast<OutputSink&>(buffer));
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    displayStats_.buildTimeMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
+}
+
+void ModelTreeBuilder::scanDirectory(TreeModel::Index node, const fs::path& path,
+                                     size_t depth, bool showHidden) {
+    std::vector<DirEntry> entries;
+    SkippedCounts skipped;
+    if (!readDirectoryEntries(path, showHidden, entries, skipped)) {
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        model_.markUnreadable(node);
+        return;
+    }
+    hiddenCount_ += skipped.hidden;
+    ignoredCount_ += skipped.ignored;
+
+    // Файлы, не прошедшие фильтры по имени, и исключенные директории
+    // не попадут ни в один вывод: ни stat, ни места в модели, ни обхода
+    if (directoriesOnly_ || !nameMatcher_.empty() || !directoryMatcher_.empty()) {
+        entries.erase(std::remove_if(entries.begin(), entries.end(), [this](const DirEntry& entry) {
+            if (entry.isDirectory) {
+                return !directoryMatcher_.matches(entry.name);
+            }
+            return directoriesOnly_ || !matchesNameFilters(entry.name);
+        }), entries.end());
+    }
+    sortEntries(entries);
+
+    // С фильтрами директория на границе глубины - только место среди
+    // соседей (см. buildView), ее метаданные не нужны
+    bool depthReached = maxDepth_ > 0 && depth + 1 >= maxDepth_;
+    bool placeholders = depthReached && (hasFilters() || directoriesOnly_);
+    std::vector<const fs::path*> paths;
+    paths.reserve(entries.size());
+    for (const auto& entry : entries) {
+        if (!(placeholders && entry.isDirectory)) {
+            paths.push_back(&entry.path);
+        }
+    }
+    std::vector<FileSystem::RawMetadata> metas;
+    std::vector<char> symlinks;
+    FileSystem::resolveMetadataBatch(paths, metas, symlinks);
+    if (placeholders && paths.size() != entries.size()) {
+        std::vector<FileSystem::RawMetadata> allMetas(entries.size());
+        std::vector<char> allSymlinks(entries.size(), 0);
+        for (size_t i = 0, k = 0; i < entries.size(); ++i) {
+            if (!entries[i].isDirectory) {
+                allMetas[i] = metas[k];
+                allSymlinks[i] = symlinks[k++];
+            }
+        }
+        metas = std::move(allMetas);
+        symlinks = std::move(allSymlinks);
+    }
+
+    TreeModel::Index first;
+    {
+        std::lock_guard<std::mutex> lock(modelMutex_);
+        first = static_cast<TreeModel::Index>(model_.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            model_.addChild(node, entries[i].name, metas[i], entries[i].isDirectory, symlinks[i] != 0);
+        }
+    }
+
+    // Директории на границе глубины не читаются: их содержимое не выводится
+    if (depthReached) {
+        return;
+    }
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!entries[i].isDirectory) {
+            continue;
+        }
+        TreeModel::Index child = first + static_cast<TreeModel::Index>(i);
+        fs::path childPath = std::move(entries[i].path);
+        pool_->submit([this, child, childPath, depth, showHidden] {
+            scanDirectory(child, childPath, depth + 1, showHidden);
+        });
+    }
+}
+
+void ModelTreeBuilder::buildView(TreeModel::Index node, size_t depth, bool filtering, bool metadataFilters) {
+    TreeModel::Index first = model_.firstChild(node);
+    for (TreeModel::Index child = first; child < first + model_.childCount(node); ++child) {
+        auto& state = view_.states[child];
+
+        if (model_.isDirectory(child)) {
+            if (maxDepth_ > 0 && depth + 1 >= maxDepth_) {
+                // Как у построителей: с фильтрами директория за границей
+                // не выводится, без них - выводится без содержимого
+                displayStats_.hiddenByDepth++;
+                if (filtering) {
+                    state = TreeView::State::PLACEHOLDER;
+                    continue;
+                }
+                state = TreeView::State::CUT;
+            } else {
+                state = TreeView::State::SHOWN;
+                buildView(child, depth + 1, filtering, metadataFilters);
+            }
+            stats_.totalDirectories++;
+            displayStats_.displayedDirectories++;
+            continue;
+        }
+
+        if (metadataFilters && !matchesMetadataFilters(model_.metadata(child))) {
+            continue;
+        }
+        state = TreeView::State::SHOWN;
+        uint64_t size = model_.fileSize(child);
+        stats_.totalFiles++;
+        stats_.totalSize += size;
+        displayStats_.displayedFiles++;
+        displayStats_.displayedSize += size;
+    }
+}
+
+void ModelTreeBuilder::writeJSON(JSONWriter& writer) const {
+    Profiler::Scope scope(Profiler::Phase::JSON);
+    JSONTreeRenderer::render(writer, model_, view_, rootPath_.string(), stats_);
+}
+
+bool ModelTreeBuilder::writeArchive(std::ostream& out) const {
+    Profiler::Scope scope(Profiler::Phase::OUTPUT);
+    return TreeArchive::write(out, model_, view_, stats_, hiddenObjectsCount_, ignoredObjectsCount_);
+}
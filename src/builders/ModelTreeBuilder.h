@@ -0,0 +1,46 @@
+#pragma once
+#include "FilteredTreeBuilder.h"
+#include "JSONWriter.h"
+#include "TreeModel.h"
+#include "TreeView.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Одно сканирование - несколько выводов. Обход (параллельный, если потоков
+// больше одного) заполняет TreeModel, фильтры и глубина один раз
+// превращаются в TreeView, а текст и JSON выводятся уже по нему.
+// Так фильтры, -L и --json работают с многопоточным обходом, а текст
+// и JSON одного запуска не читают диск дважды.
+class ModelTreeBuilder : public FilteredTreeBuilder {
+public:
+    explicit ModelTreeBuilder(const std::string& rootPath, size_t threadCount = 1);
+
+    void buildTree(bool showHidden = false) override;
+
+    // Выводить ли текстовое дерево во время buildTree; без него - только модель
+    void setTextOutput(bool enabled) { textOutput_ = enabled; }
+    // JSON того же сканирования и с теми же фильтрами, что и текст
+    void writeJSON(JSONWriter& writer) const;
+    // То же дерево в двоичном формате (--format bin)
+    bool writeArchive(std::ostream& out) const;
+    bool isMultiThreaded() const { return threadCount_ > 1; }
+
+private:
+    size_t threadCount_;
+    bool textOutput_ = true;
+    TreeModel model_;
+    TreeView view_;
+
+    // Блоки детей добавляются в модель под mutex
+    std::mutex modelMutex_;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::atomic<size_t> hiddenCount_{0};
+    std::atomic<size_t> ignoredCount_{0};
+
+    // Узел - директория на глубине depth (корень - 0)
+    void scanDirectory(TreeModel::Index node, const std::filesystem::path& path,
+                       size_t depth, bool showHidden);
+    void buildView(TreeModel::Index node, size_t depth, bool filtering, bool metadataFilters);
+};
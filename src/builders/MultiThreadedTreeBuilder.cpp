@@ -1,231 +1,262 @@
 #include "MultiThreadedTreeBuilder.h"
 #include <iostream>
 #include <algorithm>
-#include <future>
-#include <thread>
 
 namespace fs = std::filesystem;
 
 MultiThreadedTreeBuilder::MultiThreadedTreeBuilder(const std::string& rootPath, size_t threadCount)
     : TreeBuilder(rootPath), threadCount_(threadCount) {
-    
+
     if (threadCount_ == 0) {
         unsigned int hwThreads = std::thread::hardware_concurrency();
         threadCount_ = (hwThreads == 0) ? 2 : static_cast<size_t>(hwThreads);
     }
-    
+
     std::cout << "Используется потоков: " << threadCount_ << std::endl;
 }
+
 MultiThreadedTreeBuilder::~MultiThreadedTreeBuilder() {
     stopProcessing_ = true;
-    stopThreadPool();
+    pool_.reset();
 }
 
-void MultiThreadedTreeBuilder::startThreadPool() {
-    for (size_t i = 0; i < threadCount_; ++i) {
-        workers_.emplace_back([this] {
-            while (true) {
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lock(this->queueMutex_);
-                    this->condition_.wait(lock, [this] {
-                        return this->stopPool_ || !this->tasks_.empty();
-                    });
-                    if (this->stopPool_ && this->tasks_.empty()) {
-                        return;
-                    }
-                    task = std::move(this->tasks_.front());
-                    this->tasks_.pop();
-                }
-                task();
-            }
-        });
-    }
-}
-
-void MultiThreadedTreeBuilder::stopThreadPool() {
-    {
-        std::unique_lock<std::mutex> lock(queueMutex_);
-        stopPool_ = true;
-    }
-    condition_.notify_all();
-    for (std::thread &worker : workers_) {
-        if (worker.joinable()) {
-            worker.join();
-        }
-    }
-    workers_.clear();
-}
-
-void MultiThreadedTreeBuilder::addTask(std::function<void()> task) {
-    {
-        std::unique_lock<std::mutex> lock(queueMutex_);
-        if (stopPool_) return;
-        tasks_.emplace(std::move(task));
-    }
-    condition_.notify_one();
+MultiThreadedTreeBuilder::StatsShard& MultiThreadedTreeBuilder::currentShard() {
+    // Последний шард принадлежит вызывающему (не рабочему) потоку
+    int index = pool_ ? pool_->currentWorkerIndex() : -1;
+    return index >= 0 ? shards_[index] : shards_.back();
 }
 
 void MultiThreadedTreeBuilder::buildTree(bool showHidden) {
     auto startTime = std::chrono::high_resolution_clock::now();
-    
+
     treeLines_.clear();
     stats_ = Statistics{0, 0, 0};
     displayStats_ = DisplayStatistics{};
     hiddenObjectsCount_ = 0;
+    ignoredObjectsCount_ = 0;
     stopProcessing_ = false;
-    stopPool_ = false;
-    
-    startThreadPool();
-    
-    treeLines_.push_back(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
-    traverseDirectoryHybrid(rootPath_, "", true, showHidden, true);
-    
-    // Ждем завершения всех задач
-    stopThreadPool();
-    
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+
+    shards_.assign(threadCount_ + 1, StatsShard{});
+    pool_ = std::make_unique<WorkStealingPool>(threadCount_);
+
+    emitLine(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+
+    // Каждая директория - отдельная задача; вызывающий поток тем временем
+    // выводит готовые фрагменты по порядку
+    auto root = std::make_unique<DirectoryNode>();
+    DirectoryNode* rootNode = root.get();
+    pool_->submit([this, rootNode, showHidden] {
+        scanDirectory(rootNode, rootPath_, "", true, showHidden, true);
+    });
+    flushOrdered(std::move(root));
+    pool_->wait();
+    pool_.reset();
+
+    for (const auto& shard : shards_) {
+        stats_.totalFiles += shard.files;
+        stats_.totalDirectories += shard.directories;
+        stats_.totalSize += shard.size;
+        hiddenObjectsCount_ += shard.hidden;
+        ignoredObjectsCount_ += shard.ignored;
+    }
+    displayStats_.displayedFiles = stats_.totalFiles;
+    displayStats_.displayedDirectories = stats_.totalDirectories;
+    displayStats_.displayedSize = stats_.totalSize;
+
     auto endTime = std::chrono::high_resolution_clock::now();
-    displayStats_.buildTimeMicroseconds = 
+    displayStats_.buildTimeMicroseconds =
         std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
 }
 
-void MultiThreadedTreeBuilder::traverseDirectoryHybrid(const fs::path& path, 
-                                                     const std::string& prefix, 
-                                                     bool isLast,
-                                                     bool showHidden,
-                                                     bool isRoot) {
+void MultiThreadedTreeBuilder::notifyProgress() {
+    {
+        std::lock_guard<std::mutex> lock(progressMutex_);
+    }
+    progressCondition_.notify_one();
+}
+
+void MultiThreadedTreeBuilder::scanDirectory(DirectoryNode* node,
+                                             const fs::path& path,
+                                             const std::string& prefix,
+                                             bool isLast,
+                                             bool showHidden,
+                                             bool isRoot) {
     if (stopProcessing_) return;
-    
+
     if (!isRoot) {
-        auto info = FileSystem::getFileInfo(path);
-        std::string connector = isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-        
-        {
-            std::lock_guard<std::mutex> lock(treeLinesMutex_);
-            treeLines_.push_back(prefix + connector + TreeBuilder::formatTreeLine(info, connector));
-        }
-        
-        stats_.totalDirectories++;
-        displayStats_.displayedDirectories++;
+        FileSystem::RawMetadata meta;
+        bool isSymlink = false;
+        FileSystem::resolveMetadata(path, meta, isSymlink);
+        node->line.reserve(prefix.size() + path.native().size() + LINE_RESERVE);
+        node->line = prefix;
+        node->line += isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
+        LineRenderer::appendEntry(node->line, FileSystem::fileName(path), meta, isSymlink);
+        currentShard().directories++;
     }
-    
-    std::string newPrefix = prefix;
-    if (isLast) {
-        newPrefix += constants::TREE_SPACE;
+
+    auto batch = std::make_shared<FileBatch>();
+    batch->prefix = prefix + (isLast ? constants::TREE_SPACE : constants::TREE_VERTICAL);
+
+    SkippedCounts skipped;
+    bool listed = readDirectoryEntries(path, showHidden, batch->entries, skipped);
+    currentShard().hidden += skipped.hidden;
+    currentShard().ignored += skipped.ignored;
+
+    auto& entries = batch->entries;
+    if (listed) {
+        sortEntries(entries);
     } else {
-        newPrefix += constants::TREE_VERTICAL;
-    }
-    
-    std::vector<fs::directory_entry> entries;
-    
-    try {
-        for (const auto& entry : fs::directory_iterator(path)) {
-            if (stopProcessing_) return;
-            
-            bool isHidden = FileSystem::isHidden(entry.path());
-            if (!isHidden || showHidden) {
-                entries.push_back(entry);
-            } else {
-                hiddenObjectsCount_++;
-            }
-        }
-    } catch (const fs::filesystem_error&) {
-        return;
+        entries.clear();
     }
 
-    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
-        bool a_dir = a.is_directory();
-        bool b_dir = b.is_directory();
-        if (a_dir != b_dir) {
-            return a_dir > b_dir; // Директории first
-        }
-        return a.path().filename().string() < b.path().filename().string();
-    });
-    
-    // РАЗДЕЛЯЕМ НА ДИРЕКТОРИИ И ФАЙЛЫ
-    std::vector<fs::directory_entry> directories;
-    std::vector<fs::directory_entry> files;
-    
-    for (const auto& entry : entries) {
-        if (entry.is_directory()) {
-            directories.push_back(entry);
+    node->slotCount = entries.size();
+    node->slots.reset(new DirectoryNode::Slot[entries.size()]);
+
+    std::vector<DirectoryNode*> children;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (entries[i].isDirectory) {
+            node->slots[i].child = std::make_unique<DirectoryNode>();
+            children.push_back(node->slots[i].child.get());
         } else {
-            files.push_back(entry);
+            batch->fileIndices.push_back(i);
         }
     }
-    
-    // для маленьких директорий используем однопоточность
-    if (files.size() < 10 || threadCount_ == 1) {
-        for (size_t i = 0; i < entries.size(); ++i) {
-            if (stopProcessing_) break;
-            
-            const auto& entry = entries[i];
-            bool entryIsLast = (i == entries.size() - 1);
-            
-            if (entry.is_directory()) {
-                traverseDirectoryHybrid(entry.path(), newPrefix, entryIsLast, showHidden, false);
-            } else {
-                auto info = FileSystem::getFileInfo(entry.path());
-                std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-                
-                {
-                    std::lock_guard<std::mutex> lock(treeLinesMutex_);
-                    treeLines_.push_back(newPrefix + connector + TreeBuilder::formatTreeLine(info, connector));
-                }
-                
-                stats_.totalFiles++;
-                stats_.totalSize += info.size;
-                displayStats_.displayedFiles++;
-                displayStats_.displayedSize += info.size;
-            }
+
+    // Структура фрагмента готова: строку директории уже можно выводить
+    node->ready.store(true, std::memory_order_release);
+    notifyProgress();
+
+    // Поддиректории становятся задачами, их может забрать любой рабочий
+    size_t childIndex = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!entries[i].isDirectory) {
+            continue;
         }
-    } else {
-        
-        std::vector<std::future<FileSystem::FileInfo>> fileFutures;
-        fileFutures.reserve(files.size());
-        
-        for (const auto& file : files) {
-            if (stopProcessing_) break;
-            
-            auto promise = std::make_shared<std::promise<FileSystem::FileInfo>>();
-            fileFutures.push_back(promise->get_future());
-            
-            addTask([file, promise, this]() {
-                if (stopProcessing_) {
-                    promise->set_value(FileSystem::FileInfo());
-                    return;
-                }
-                promise->set_value(FileSystem::getFileInfo(file.path()));
-            });
+        DirectoryNode* childNode = children[childIndex++];
+        bool entryIsLast = (i == entries.size() - 1);
+        fs::path childPath = entries[i].path;
+        std::string childPrefix = batch->prefix;
+        pool_->submit([this, childNode, childPath, childPrefix, entryIsLast, showHidden] {
+            scanDirectory(childNode, childPath, childPrefix, entryIsLast, showHidden, false);
+        });
+    }
+
+    // Файлы читаются пачками: первая - в текущей задаче, остальные - отдельными задачами
+    std::shared_ptr<const FileBatch> sharedBatch = batch;
+    size_t fileCount = batch->fileIndices.size();
+    for (size_t begin = FILE_CHUNK_SIZE; begin < fileCount; begin += FILE_CHUNK_SIZE) {
+        size_t end = std::min(begin + FILE_CHUNK_SIZE, fileCount);
+        pool_->submit([this, node, sharedBatch, begin, end] {
+            scanFiles(node, sharedBatch, begin, end);
+        });
+    }
+    scanFiles(node, sharedBatch, 0, std::min(FILE_CHUNK_SIZE, fileCount));
+}
+
+void MultiThreadedTreeBuilder::scanFiles(DirectoryNode* node,
+                                         const std::shared_ptr<const FileBatch>& batch,
+                                         size_t begin, size_t end) {
+    if (begin >= end) return;
+
+    StatsShard& shard = currentShard();
+
+    // Метаданные всей пачки - одним запросом (io_uring, если доступен)
+    std::vector<const fs::path*> paths;
+    paths.reserve(end - begin);
+    for (size_t k = begin; k < end; ++k) {
+        paths.push_back(&batch->entries[batch->fileIndices[k]].path);
+    }
+    std::vector<FileSystem::RawMetadata> metas;
+    std::vector<char> symlinks;
+    FileSystem::resolveMetadataBatch(paths, metas, symlinks);
+
+    for (size_t k = begin; k < end; ++k) {
+        if (stopProcessing_) return;
+
+        size_t index = batch->fileIndices[k];
+        bool entryIsLast = (index == batch->entries.size() - 1);
+        const auto& entry = batch->entries[index];
+        const auto& meta = metas[k - begin];
+        uint64_t size = FileSystem::entrySize(meta);
+
+        shard.files++;
+        shard.size += size;
+
+        // После done слот принадлежит потоку вывода и может быть освобожден
+        auto& slot = node->slots[index];
+        slot.line.reserve(batch->prefix.size() + entry.name.size() + LINE_RESERVE);
+        slot.line = batch->prefix;
+        slot.line += entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
+        LineRenderer::appendEntry(slot.line, entry.name, meta, symlinks[k - begin] != 0);
+        slot.size = size;
+        slot.done.store(true, std::memory_order_release);
+    }
+
+    notifyProgress();
+}
+
+uint64_t MultiThreadedTreeBuilder::flushOrdered(std::unique_ptr<DirectoryNode> root) {
+    struct Frame {
+        DirectoryNode* node;
+        size_t nextSlot = 0;
+        bool lineEmitted = false;
+        uint64_t size = 0;
+    };
+
+    std::vector<Frame> stack;
+    stack.push_back(Frame{root.get()});
+    uint64_t totalSize = 0;
+
+    auto waitFor = [this](const std::atomic<bool>& flag) {
+        if (flag.load(std::memory_order_acquire)) {
+            return true;
         }
-        
-        // Обрабатываем директории пока файлы считаются
-        for (size_t i = 0; i < directories.size(); ++i) {
-            if (stopProcessing_) break;
-            
-            bool entryIsLast = (i == directories.size() - 1 && files.empty());
-            traverseDirectoryHybrid(directories[i].path(), newPrefix, entryIsLast, showHidden, false);
+        std::unique_lock<std::mutex> lock(progressMutex_);
+        progressCondition_.wait(lock, [&] {
+            return flag.load(std::memory_order_acquire) || stopProcessing_;
+        });
+        return flag.load(std::memory_order_acquire);
+    };
+
+    while (!stack.empty()) {
+        Frame& frame = stack.back();
+        DirectoryNode* node = frame.node;
+
+        if (!frame.lineEmitted) {
+            if (!waitFor(node->ready)) return totalSize;
+            if (!node->line.empty()) {
+                emitLine(node->line);
+            }
+            frame.lineEmitted = true;
         }
-        
-        // Собираем результаты файлов
-        for (size_t i = 0; i < fileFutures.size(); ++i) {
-            if (stopProcessing_) break;
-            
-            auto info = fileFutures[i].get();
-            if (info.name.empty()) continue;
-            
-            bool entryIsLast = (directories.size() + i == entries.size() - 1);
-            std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-            
-            {
-                std::lock_guard<std::mutex> lock(treeLinesMutex_);
-                treeLines_.push_back(newPrefix + connector + TreeBuilder::formatTreeLine(info, connector));
+
+        if (frame.nextSlot == node->slotCount) {
+            // Поддерево выведено целиком: память фрагмента больше не нужна
+            uint64_t size = frame.size;
+            stack.pop_back();
+            if (stack.empty()) {
+                totalSize = size;
+            } else {
+                Frame& parent = stack.back();
+                parent.size += size;
+                parent.node->slots[parent.nextSlot - 1].child.reset();
             }
-            
-            stats_.totalFiles++;
-            stats_.totalSize += info.size;
-            displayStats_.displayedFiles++;
-            displayStats_.displayedSize += info.size;
+            continue;
         }
+
+        auto& slot = node->slots[frame.nextSlot++];
+        if (slot.child) {
+            stack.push_back(Frame{slot.child.get()});
+            continue;
+        }
+
+        if (!waitFor(slot.done)) return totalSize;
+        emitLine(slot.line);
+        frame.size += slot.size;
+        std::string().swap(slot.line);
     }
-}
\ No newline at end of file
+
+    return totalSize;
+}
@@ -1,38 +1,78 @@
 #pragma once
 #include "TreeBuilder.h"
+#include "WorkStealingPool.h"
 #include <atomic>
 #include <chrono>
-#include <mutex>
-#include <queue>
 #include <condition_variable>
-#include <future>
+#include <mutex>
+#include <memory>
 #include <thread>
 
 class MultiThreadedTreeBuilder : public TreeBuilder {
 public:
     explicit MultiThreadedTreeBuilder(const std::string& rootPath, size_t threadCount = 0);
     ~MultiThreadedTreeBuilder();
-    
+
     void buildTree(bool showHidden = false) override;
 
 private:
+    // Файлы одной директории читаются пачками такого размера
+    static constexpr size_t FILE_CHUNK_SIZE = 64;
+    // Запас под описание элемента сверх отступа и имени (цвета, размер,
+    // дата, права), чтобы строка слота выделялась один раз
+    static constexpr size_t LINE_RESERVE = 128;
+
+    // Фрагмент вывода директории: собственная строка и по слоту на элемент.
+    // Слоты заполняются разными задачами, а поток вывода выдает их в порядке
+    // сортировки, как только готовы все предшествующие фрагменты.
+    struct DirectoryNode {
+        struct Slot {
+            std::string line;
+            uint64_t size = 0;
+            std::unique_ptr<DirectoryNode> child;
+            std::atomic<bool> done{false};
+        };
+
+        std::string line;
+        std::unique_ptr<Slot[]> slots;
+        size_t slotCount = 0;
+        std::atomic<bool> ready{false};
+    };
+
+    // Файлы директории, разделяемые между задачами-пачками
+    struct FileBatch {
+        std::vector<DirEntry> entries;
+        std::vector<size_t> fileIndices;
+        std::string prefix;
+    };
+
+    // Статистика каждого рабочего в своей кэш-линии, сводится в конце
+    struct alignas(64) StatsShard {
+        size_t files = 0;
+        size_t directories = 0;
+        size_t hidden = 0;
+        size_t ignored = 0;
+        uint64_t size = 0;
+    };
+
     size_t threadCount_;
     std::atomic<bool> stopProcessing_{false};
-    mutable std::mutex treeLinesMutex_;
-    
-    std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex queueMutex_;
-    std::condition_variable condition_;
-    std::atomic<bool> stopPool_{false};
-    
-    void startThreadPool();
-    void stopThreadPool();
-    void addTask(std::function<void()> task);
-    
-    void traverseDirectoryHybrid(const std::filesystem::path& path, 
-                                const std::string& prefix, 
-                                bool isLast,
-                                bool showHidden,
-                                bool isRoot = false);
-};
\ No newline at end of file
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::vector<StatsShard> shards_;
+    std::mutex progressMutex_;
+    std::condition_variable progressCondition_;
+
+    StatsShard& currentShard();
+
+    void scanDirectory(DirectoryNode* node,
+                       const std::filesystem::path& path,
+                       const std::string& prefix,
+                       bool isLast,
+                       bool showHidden,
+                       bool isRoot);
+    void scanFiles(DirectoryNode* node,
+                   const std::shared_ptr<const FileBatch>& batch,
+                   size_t begin, size_t end);
+    void notifyProgress();
+    uint64_t flushOrdered(std::unique_ptr<DirectoryNode> root);
+};
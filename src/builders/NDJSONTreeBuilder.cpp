@@ -0,0 +1,171 @@
+#include "NDJSONTreeBuilder.h"
+#include "JSONWriter.h"
+#include <charconv>
+#include <iostream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    template <typename T>
+    void appendNumber(std::string& out, T number) {
+        char digits[24];
+        auto result = std::to_chars(digits, digits + sizeof(digits), number);
+        out.append(digits, result.ptr);
+    }
+
+    int64_t epochSeconds(int64_t ns) {
+        int64_t seconds = ns / 1000000000LL;
+        return ns % 1000000000LL < 0 ? seconds - 1 : seconds;
+    }
+}
+
+NDJSONTreeBuilder::NDJSONTreeBuilder(const std::string& rootPath, size_t threadCount)
+    : TreeBuilder(rootPath), threadCount_(threadCount) {
+
+    if (threadCount_ == 0) {
+        unsigned int hwThreads = std::thread::hardware_concurrency();
+        threadCount_ = (hwThreads == 0) ? 2 : static_cast<size_t>(hwThreads);
+    }
+}
+
+void NDJSONTreeBuilder::buildTree(bool showHidden) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    treeLines_.clear();
+    stats_ = Statistics{0, 0, 0};
+    displayStats_ = DisplayStatistics{};
+    files_ = 0;
+    directories_ = 0;
+    hidden_ = 0;
+    ignored_ = 0;
+    size_ = 0;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+
+    if (threadCount_ > 1) {
+        // stdout занят записями
+        std::cerr << "Используется потоков: " << threadCount_ << std::endl;
+        pool_ = std::make_unique<WorkStealingPool>(threadCount_);
+        pool_->submit([this, showHidden] {
+            scanDirectory(rootPath_, 0, showHidden);
+        });
+        pool_->wait();
+        pool_.reset();
+    } else {
+        scanDirectory(rootPath_, 0, showHidden);
+    }
+
+    stats_.totalFiles = files_;
+    stats_.totalDirectories = directories_;
+    stats_.totalSize = size_;
+    hiddenObjectsCount_ = hidden_;
+    ignoredObjectsCount_ = ignored_;
+    displayStats_.displayedFiles = stats_.totalFiles;
+    displayStats_.displayedDirectories = stats_.totalDirectories;
+    displayStats_.displayedSize = stats_.totalSize;
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    displayStats_.buildTimeMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
+}
+
+void NDJSONTreeBuilder::scanDirectory(const fs::path& path, size_t depth, bool showHidden) {
+    std::vector<DirEntry> entries;
+    SkippedCounts skipped;
+    std::string block;
+    if (!readDirectoryEntries(path, showHidden, entries, skipped)) {
+        block += "{\"depth\":";
+        appendNumber(block, depth);
+        block += ",\"error\":\"Permission denied\",\"path\":";
+        JSONWriter::appendString(block, path.native());
+        block += "}\n";
+        writeBlock(block);
+        return;
+    }
+    hidden_ += skipped.hidden;
+    ignored_ += skipped.ignored;
+    sortEntries(entries);
+
+    std::vector<const fs::path*> paths;
+    paths.reserve(entries.size());
+    for (const auto& entry : entries) {
+        paths.push_back(&entry.path);
+    }
+    std::vector<FileSystem::RawMetadata> metas;
+    std::vector<char> symlinks;
+    FileSystem::resolveMetadataBatch(paths, metas, symlinks);
+
+    {
+        Profiler::Scope scope(Profiler::Phase::JSON);
+        block.reserve(entries.size() * 128);
+        size_t files = 0;
+        size_t directories = 0;
+        uint64_t size = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            appendRecord(block, entries[i].path.native(), depth + 1, metas[i],
+                         entries[i].isDirectory, symlinks[i] != 0);
+            if (entries[i].isDirectory) {
+                directories++;
+            } else {
+                files++;
+                size += metas[i].size;
+            }
+        }
+        files_ += files;
+        directories_ += directories;
+        size_ += size;
+    }
+    writeBlock(block);
+    block = std::string();
+
+    if (maxDepth_ > 0 && depth + 1 >= maxDepth_) {
+        return;
+    }
+    // Дальше нужны только пути поддиректорий
+    std::vector<fs::path> subdirectories;
+    for (auto& entry : entries) {
+        if (entry.isDirectory) {
+            subdirectories.push_back(std::move(entry.path));
+        }
+    }
+    entries = std::vector<DirEntry>();
+
+    for (auto& subdirectory : subdirectories) {
+        if (pool_) {
+            pool_->submit([this, subdirectory = std::move(subdirectory), depth, showHidden] {
+                scanDirectory(subdirectory, depth + 1, showHidden);
+            });
+        } else {
+            scanDirectory(subdirectory, depth + 1, showHidden);
+        }
+    }
+}
+
+void NDJSONTreeBuilder::writeBlock(const std::string& block) {
+    if (block.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(outputMutex_);
+    if (sink_) {
+        sink_->writeBlock(block);
+    } else {
+        BufferSink(treeLines_).writeBlock(block);
+    }
+}
+
+void NDJSONTreeBuilder::appendRecord(std::string& out, const std::string& path, size_t depth,
+                                     const FileSystem::RawMetadata& meta, bool isDirectory, bool isSymlink) {
+    // Ключи по алфавиту, как в --json
+    out += "{\"depth\":";
+    appendNumber(out, depth);
+    out += isSymlink ? ",\"isSymlink\":true,\"mode\":" : ",\"isSymlink\":false,\"mode\":";
+    appendNumber(out, meta.mode);
+    out += ",\"mtime\":";
+    appendNumber(out, epochSeconds(meta.mtimeNs));
+    out += ",\"path\":";
+    JSONWriter::appendString(out, path);
+    out += ",\"size\":";
+    appendNumber(out, meta.size);
+    out += isDirectory ? ",\"type\":\"directory\"}\n" : ",\"type\":\"file\"}\n";
+}
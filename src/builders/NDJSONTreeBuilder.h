@@ -0,0 +1,43 @@
+#pragma once
+#include "TreeBuilder.h"
+#include "WorkStealingPool.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+// Плоский поток записей (--ndjson): JSON-объект в строке на каждый элемент,
+// без вложенных "contents". Записи каталога форматируются и выводятся одним
+// блоком сразу после его чтения, так что в памяти - записи одного каталога
+// на поток. В несколько потоков каталоги обходятся параллельно, и блоки
+// разных каталогов идут в порядке готовности; внутри блока - порядок сортировки.
+class NDJSONTreeBuilder : public TreeBuilder {
+public:
+    explicit NDJSONTreeBuilder(const std::string& rootPath, size_t threadCount = 1);
+
+    void buildTree(bool showHidden = false) override;
+
+    // Записи до этой глубины включительно (0 - без ограничения)
+    void setMaxDepth(size_t maxDepth) { maxDepth_ = maxDepth; }
+    bool isMultiThreaded() const { return threadCount_ > 1; }
+
+    // Запись элемента с '\n' в конец out: depth, isSymlink, mode, mtime
+    // (секунды от эпохи), path, size (st_size как есть), type
+    static void appendRecord(std::string& out, const std::string& path, size_t depth,
+                             const FileSystem::RawMetadata& meta, bool isDirectory, bool isSymlink);
+
+private:
+    size_t threadCount_;
+    size_t maxDepth_ = 0;
+    std::unique_ptr<WorkStealingPool> pool_;
+    std::mutex outputMutex_;
+
+    std::atomic<size_t> files_{0};
+    std::atomic<size_t> directories_{0};
+    std::atomic<size_t> hidden_{0};
+    std::atomic<size_t> ignored_{0};
+    std::atomic<uint64_t> size_{0};
+
+    // depth - глубина самого каталога (корень - 0)
+    void scanDirectory(const std::filesystem::path& path, size_t depth, bool showHidden);
+    void writeBlock(const std::string& block);
+};
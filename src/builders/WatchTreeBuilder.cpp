@@ -0,0 +1,438 @@
+#include "WatchTreeBuilder.h"
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+#ifdef __linux__
+    constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE |
+                                    IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+    // Пачка событий собирается, пока они идут чаще, чем раз в это время
+    constexpr int DEBOUNCE_MS = 100;
+    constexpr size_t EVENT_BUFFER_SIZE = 64 * 1024;
+#endif
+
+    bool sameMetadata(const FileSystem::FileInfo& a, const FileSystem::FileInfo& b) {
+        return a.meta.mode == b.meta.mode && a.meta.size == b.meta.size &&
+               a.meta.mtimeNs == b.meta.mtimeNs && a.isSymlink == b.isSymlink;
+    }
+}
+
+WatchTreeBuilder::WatchTreeBuilder(const std::string& rootPath) : TreeBuilder(rootPath) {}
+
+WatchTreeBuilder::~WatchTreeBuilder() {
+    if (inotifyFd_ >= 0) {
+        ::close(inotifyFd_);
+    }
+}
+
+void WatchTreeBuilder::buildTree(bool showHidden) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    treeLines_.clear();
+    stats_ = Statistics{0, 0, 0};
+    displayStats_ = DisplayStatistics{};
+    hiddenObjectsCount_ = 0;
+    ignoredObjectsCount_ = 0;
+    showHidden_ = showHidden;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+
+    watches_.clear();
+    if (inotifyFd_ >= 0) {
+        ::close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+#ifdef __linux__
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ < 0) {
+        std::cerr << "Ошибка: не удалось инициализировать inotify" << std::endl;
+    }
+#endif
+
+    root_ = std::make_unique<Node>();
+    root_->isDirectory = true;
+    root_->info.isDirectory = true;
+    // Наблюдение ставится до чтения каталога, чтобы не пропустить изменения между ними
+    addWatch(root_.get(), rootPath_);
+    scanChildren(root_.get(), rootPath_);
+
+    renderTree();
+    updateStatistics();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    displayStats_.buildTimeMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
+}
+
+std::unique_ptr<WatchTreeBuilder::Node> WatchTreeBuilder::scanNode(const fs::path& path,
+                                                                   const DirEntry* entry, Node* parent) {
+    auto node = std::make_unique<Node>();
+    node->parent = parent;
+    node->info = FileSystem::getFileInfo(path);
+    node->isDirectory = entry->isDirectory;
+    if (node->isDirectory) {
+        addWatch(node.get(), path);
+        scanChildren(node.get(), path);
+    }
+    return node;
+}
+
+void WatchTreeBuilder::scanChildren(Node* node, const fs::path& path) {
+    std::vector<DirEntry> entries;
+    SkippedCounts skipped;
+    if (readDirectoryEntries(path, showHidden_, entries, skipped)) {
+        sortEntries(entries);
+        node->skipped = skipped;
+        node->children.reserve(entries.size());
+        for (const auto& entry : entries) {
+            node->children.push_back(scanNode(entry.path, &entry, node));
+        }
+    }
+    recomputeTotals(node);
+}
+
+void WatchTreeBuilder::addWatch(Node* node, const fs::path& path) {
+#ifdef __linux__
+    if (inotifyFd_ < 0) {
+        return;
+    }
+    int watch = inotify_add_watch(inotifyFd_, path.c_str(), WATCH_MASK);
+    if (watch < 0) {
+        if (errno == ENOSPC && !watchLimitReported_) {
+            std::cerr << "Предупреждение: исчерпан лимит inotify (fs.inotify.max_user_watches), "
+                      << "часть директорий не отслеживается" << std::endl;
+            watchLimitReported_ = true;
+        }
+        return;
+    }
+    // Тот же inode (директорию переместили) дает тот же дескриптор - он переходит к новому узлу
+    if (node->watch >= 0 && node->watch != watch) {
+        auto previous = watches_.find(node->watch);
+        if (previous != watches_.end() && previous->second == node) {
+            watches_.erase(previous);
+        }
+    }
+    node->watch = watch;
+    watches_[watch] = node;
+#else
+    (void)node;
+    (void)path;
+#endif
+}
+
+void WatchTreeBuilder::rewatch(Node* node, const fs::path& path) {
+    addWatch(node, path);
+    for (auto& child : node->children) {
+        if (child->isDirectory) {
+            rewatch(child.get(), path / child->info.name);
+        }
+    }
+}
+
+void WatchTreeBuilder::removeWatches(Node* node) {
+    for (auto& child : node->children) {
+        removeWatches(child.get());
+    }
+#ifdef __linux__
+    auto it = watches_.find(node->watch);
+    if (it != watches_.end() && it->second == node) {
+        inotify_rm_watch(inotifyFd_, node->watch);
+        watches_.erase(it);
+    }
+#endif
+    node->watch = -1;
+}
+
+WatchTreeBuilder::Totals WatchTreeBuilder::contribution(const Node* node) {
+    Totals result;
+    if (node->isDirectory) {
+        result = node->totals;
+        result.directories++;
+    } else {
+        result.files = 1;
+        result.size = node->info.size;
+    }
+    return result;
+}
+
+void WatchTreeBuilder::recomputeTotals(Node* node) {
+    Totals totals;
+    totals.hidden = node->skipped.hidden;
+    totals.ignored = node->skipped.ignored;
+    for (const auto& child : node->children) {
+        Totals part = contribution(child.get());
+        totals.files += part.files;
+        totals.directories += part.directories;
+        totals.hidden += part.hidden;
+        totals.ignored += part.ignored;
+        totals.size += part.size;
+    }
+    node->totals = totals;
+}
+
+void WatchTreeBuilder::propagate(Node* from, const Totals& before, const Totals& after) {
+    // Беззнаковое переполнение при вычитании компенсируется прибавлением
+    for (Node* ancestor = from->parent; ancestor; ancestor = ancestor->parent) {
+        ancestor->totals.files += after.files - before.files;
+        ancestor->totals.directories += after.directories - before.directories;
+        ancestor->totals.hidden += after.hidden - before.hidden;
+        ancestor->totals.ignored += after.ignored - before.ignored;
+        ancestor->totals.size += after.size - before.size;
+    }
+}
+
+void WatchTreeBuilder::syncDirectory(Node* node, bool recursive, std::vector<Change>& changes) {
+    fs::path path = pathOf(node);
+    if (node != root_.get()) {
+        node->info = FileSystem::getFileInfo(path);
+    }
+
+    std::vector<DirEntry> entries;
+    SkippedCounts skipped;
+    if (!readDirectoryEntries(path, showHidden_, entries, skipped)) {
+        // Директория исчезла: узел удалит событие ее родителя
+        return;
+    }
+    sortEntries(entries);
+
+    std::unordered_map<std::string, std::unique_ptr<Node>> previous;
+    for (auto& child : node->children) {
+        std::string name = child->info.name;
+        previous.emplace(std::move(name), std::move(child));
+    }
+
+    std::vector<std::unique_ptr<Node>> children;
+    children.reserve(entries.size());
+    for (const auto& entry : entries) {
+        auto it = previous.find(entry.name);
+        if (it == previous.end() || it->second->isDirectory != entry.isDirectory) {
+            children.push_back(scanNode(entry.path, &entry, node));
+            changes.push_back({Change::Kind::ADDED, relativePathOf(children.back().get()), children.back()->info});
+            continue;
+        }
+
+        std::unique_ptr<Node> child = std::move(it->second);
+        previous.erase(it);
+        if (child->isDirectory) {
+            if (recursive) {
+                syncDirectory(child.get(), true, changes);
+            } else {
+                child->info = FileSystem::getFileInfo(entry.path);
+            }
+        } else {
+            auto info = FileSystem::getFileInfo(entry.path);
+            if (!sameMetadata(info, child->info)) {
+                child->info = std::move(info);
+                changes.push_back({Change::Kind::MODIFIED, relativePathOf(child.get()), child->info});
+            }
+        }
+        children.push_back(std::move(child));
+    }
+
+    for (auto& [name, removed] : previous) {
+        changes.push_back({Change::Kind::REMOVED, relativePathOf(removed.get()), removed->info});
+        removeWatches(removed.get());
+    }
+
+    node->children = std::move(children);
+    node->skipped = skipped;
+    recomputeTotals(node);
+}
+
+void WatchTreeBuilder::refreshChild(Node* node, const std::string& name, std::vector<Change>& changes) {
+    if (!showHidden_ && !name.empty() && name[0] == '.') {
+        return;
+    }
+
+    auto it = std::find_if(node->children.begin(), node->children.end(),
+        [&name](const std::unique_ptr<Node>& child) { return child->info.name == name; });
+    if (it == node->children.end()) {
+        syncDirectory(node, false, changes);
+        return;
+    }
+
+    Node* child = it->get();
+    auto info = FileSystem::getFileInfo(pathOf(child));
+    if (info.meta.mode == 0) {
+        // Файл уже удален - список директории сверяется целиком
+        syncDirectory(node, false, changes);
+        return;
+    }
+    if (!sameMetadata(info, child->info)) {
+        child->info = std::move(info);
+        if (!child->isDirectory) {
+            changes.push_back({Change::Kind::MODIFIED, relativePathOf(child), child->info});
+        }
+    }
+    recomputeTotals(node);
+}
+
+bool WatchTreeBuilder::waitForChanges(std::vector<Change>& changes) {
+#ifdef __linux__
+    if (inotifyFd_ < 0) {
+        return false;
+    }
+
+    struct Dirty {
+        bool relist = false;
+        std::vector<std::string> names;
+    };
+    std::unordered_map<int, Dirty> dirty;
+    std::vector<int> order;
+    bool overflow = false;
+
+    std::vector<char> buffer(EVENT_BUFFER_SIZE);
+    int timeout = -1;
+    while (true) {
+        pollfd pfd{inotifyFd_, POLLIN, 0};
+        int ready = ::poll(&pfd, 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            return false;
+        }
+        if (ready <= 0) {
+            break;
+        }
+
+        ssize_t bytes = ::read(inotifyFd_, buffer.data(), buffer.size());
+        if (bytes < 0 && errno != EAGAIN) {
+            return false;
+        }
+        for (ssize_t offset = 0; offset < bytes; ) {
+            auto* event = reinterpret_cast<inotify_event*>(buffer.data() + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                overflow = true;
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                // Ядро сняло наблюдение (директория удалена)
+                auto it = watches_.find(event->wd);
+                if (it != watches_.end()) {
+                    it->second->watch = -1;
+                    watches_.erase(it);
+                }
+                continue;
+            }
+
+            auto [it, inserted] = dirty.try_emplace(event->wd);
+            if (inserted) {
+                order.push_back(event->wd);
+            }
+            if (event->mask & (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO)) {
+                it->second.relist = true;
+            } else if (event->len > 0) {
+                it->second.names.emplace_back(event->name);
+            }
+        }
+        timeout = DEBOUNCE_MS;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
+
+    fullRefresh_ = overflow;
+    if (overflow) {
+        // Потерянные события могли относиться к любой директории, поэтому
+        // пересканируется все дерево, а наблюдения ставятся заново
+        std::cerr << "Предупреждение: переполнение очереди inotify, пересканируется "
+                  << rootPath_.string() << std::endl;
+        syncDirectory(root_.get(), true, changes);
+        rewatch(root_.get(), rootPath_);
+    } else {
+        // Узлы ищутся по дескриптору в момент обработки: предыдущая сверка
+        // могла удалить директорию вместе с ее наблюдением
+        for (int watch : order) {
+            auto found = watches_.find(watch);
+            if (found == watches_.end()) {
+                continue;
+            }
+            Node* node = found->second;
+
+            Totals before = contribution(node);
+            const Dirty& entry = dirty[watch];
+            if (entry.relist) {
+                syncDirectory(node, false, changes);
+            } else {
+                for (const auto& name : entry.names) {
+                    refreshChild(node, name, changes);
+                }
+            }
+            propagate(node, before, contribution(node));
+        }
+    }
+
+    updateStatistics();
+    auto endTime = std::chrono::high_resolution_clock::now();
+    displayStats_.buildTimeMicroseconds =
+        std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
+    return true;
+#else
+    (void)changes;
+    return false;
+#endif
+}
+
+fs::path WatchTreeBuilder::pathOf(const Node* node) const {
+    std::vector<const Node*> chain;
+    for (const Node* n = node; n != root_.get(); n = n->parent) {
+        chain.push_back(n);
+    }
+    fs::path path = rootPath_;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        path /= (*it)->info.name;
+    }
+    return path;
+}
+
+std::string WatchTreeBuilder::relativePathOf(const Node* node) const {
+    std::string path;
+    for (const Node* n = node; n != root_.get(); n = n->parent) {
+        path = path.empty() ? n->info.name : n->info.name + "/" + path;
+    }
+    return path;
+}
+
+void WatchTreeBuilder::renderTree() {
+    renderer_.clear();
+    emitLine(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+    renderer_.pushLevel(true);
+    renderChildren(root_.get());
+    renderer_.popLevel();
+}
+
+void WatchTreeBuilder::renderChildren(const Node* node) {
+    for (size_t i = 0; i < node->children.size(); ++i) {
+        const Node* child = node->children[i].get();
+        bool isLast = (i == node->children.size() - 1);
+        renderEntryLine(child->info, isLast);
+        emitLine(renderer_.line());
+        if (child->isDirectory) {
+            renderer_.pushLevel(isLast);
+            renderChildren(child);
+            renderer_.popLevel();
+        }
+    }
+}
+
+void WatchTreeBuilder::updateStatistics() {
+    const Totals& totals = root_->totals;
+    stats_.totalFiles = totals.files;
+    stats_.totalDirectories = totals.directories;
+    stats_.totalSize = totals.size;
+    displayStats_.displayedFiles = totals.files;
+    displayStats_.displayedDirectories = totals.directories;
+    displayStats_.displayedSize = totals.size;
+    hiddenObjectsCount_ = totals.hidden;
+    ignoredObjectsCount_ = totals.ignored;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "TreeBuilder.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Режим наблюдения (--watch): дерево строится один раз и хранится в памяти,
+// на каждую директорию ставится inotify-наблюдение. События обновляют только
+// затронутые узлы и итоги их предков; переполнение очереди (IN_Q_OVERFLOW)
+// приводит к пересканированию всего дерева и повторной установке наблюдений.
+class WatchTreeBuilder : public TreeBuilder {
+public:
+    // Изменение, примененное по событиям: добавлен, удален или изменен элемент
+    struct Change {
+        enum class Kind { ADDED, REMOVED, MODIFIED } kind;
+        std::string relativePath;
+        FileSystem::FileInfo info;
+    };
+
+    explicit WatchTreeBuilder(const std::string& rootPath);
+    ~WatchTreeBuilder();
+
+    void buildTree(bool showHidden = false) override;
+
+    // Выводит текущее дерево из памяти, без обращения к файловой системе
+    void renderTree();
+
+    // Ждет пачку событий, применяет их и возвращает изменения.
+    // false - наблюдение невозможно (нет inotify или дескриптор закрыт).
+    bool waitForChanges(std::vector<Change>& changes);
+    // Последняя пачка потеряла события и дерево пересканировано целиком
+    bool wasFullRefresh() const { return fullRefresh_; }
+
+private:
+    struct Totals {
+        size_t files = 0;
+        size_t directories = 0;
+        size_t hidden = 0;
+        size_t ignored = 0;
+        uint64_t size = 0;
+    };
+
+    struct Node {
+        FileSystem::FileInfo info;
+        Node* parent = nullptr;
+        // Дети в порядке вывода: директории, затем файлы, по имени
+        std::vector<std::unique_ptr<Node>> children;
+        // Обходится как директория (в том числе симлинк на директорию)
+        bool isDirectory = false;
+        int watch = -1;
+        SkippedCounts skipped;
+        // Итоги поддерева без самой директории
+        Totals totals;
+    };
+
+    std::unique_ptr<Node> root_;
+    bool showHidden_ = false;
+    int inotifyFd_ = -1;
+    bool watchLimitReported_ = false;
+    bool fullRefresh_ = false;
+    std::unordered_map<int, Node*> watches_;
+
+    std::unique_ptr<Node> scanNode(const std::filesystem::path& path, const DirEntry* entry, Node* parent);
+    void scanChildren(Node* node, const std::filesystem::path& path);
+    void addWatch(Node* node, const std::filesystem::path& path);
+    // Ставит наблюдения на все директории поддерева (после переполнения)
+    void rewatch(Node* node, const std::filesystem::path& path);
+    void removeWatches(Node* node);
+
+    // Перечитывает директорию и сверяет детей; recursive - и все поддерево
+    void syncDirectory(Node* node, bool recursive, std::vector<Change>& changes);
+    void refreshChild(Node* node, const std::string& name, std::vector<Change>& changes);
+    void recomputeTotals(Node* node);
+    // Вклад узла в итоги родителя
+    static Totals contribution(const Node* node);
+    void propagate(Node* from, const Totals& before, const Totals& after);
+
+    std::filesystem::path pathOf(const Node* node) const;
+    std::string relativePathOf(const Node* node) const;
+    void renderChildren(const Node* node);
+    void updateStatistics();
+};
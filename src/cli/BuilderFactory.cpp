@@ -4,6 +4,10 @@
 #include "FilteredTreeBuilder.h"
 #include "MultiThreadedTreeBuilder.h"
 #include "GitHubTreeBuilder.h"
+#include "WatchTreeBuilder.h"
+#include "ModelTreeBuilder.h"
+#include "ArchiveTreeBuilder.h"
+#include "NDJSONTreeBuilder.h"
 
 std::unique_ptr<TreeBuilder> BuilderFactory::createBuilder(
     const std::string& path, 
@@ -43,10 +47,54 @@ std::unique_ptr<TreeBuilder> BuilderFactory::createBuilder(
     return std::make_unique<TreeBuilder>(path);
 }
 
+bool BuilderFactory::needsModel(const CommandLineOptions& options) {
+    bool multiThreaded = options.threadCount != 1;
+    bool depthLimited = options.maxDepth > 0;
+    if (!options.jsonOutputFile.empty() || options.binaryOutput) {
+        return true;
+    }
+    if (options.useJSON) {
+        return options.useFilteredBuilder || depthLimited || multiThreaded;
+    }
+    // Фильтры вместе с -L умеет FilteredTreeBuilder, но не в несколько потоков
+    return multiThreaded && (options.useFilteredBuilder || depthLimited);
+}
+
 std::unique_ptr<TreeBuilder> BuilderFactory::create(const CommandLineOptions& options) {
 
     std::string targetPath = options.isGitHub ? options.githubUrl : options.path;
     
+    if (options.watch) {
+        return std::make_unique<WatchTreeBuilder>(targetPath);
+    }
+    
+    if (options.ndjson) {
+        auto builder = std::make_unique<NDJSONTreeBuilder>(targetPath, options.threadCount);
+        builder->setMaxDepth(options.maxDepth);
+        return builder;
+    }
+    
+    if (!options.loadFile.empty()) {
+        auto builder = std::make_unique<ArchiveTreeBuilder>(options.loadFile);
+        builder->setTextOutput(!options.useJSON);
+        return builder;
+    }
+    
+    // Итоги скрытых поддеревьев; потоки - только для их подсчета
+    if (options.depthSummary) {
+        auto builder = std::make_unique<DepthViewTreeBuilder>(targetPath, options.maxDepth);
+        builder->setCutoffMode(DepthViewTreeBuilder::CutoffMode::SUMMARY, options.threadCount);
+        return builder;
+    }
+    
+    // Одно сканирование в модель, по которой строятся все нужные выводы
+    if (!options.isGitHub && needsModel(options)) {
+        auto builder = std::make_unique<ModelTreeBuilder>(targetPath, options.threadCount);
+        builder->setMaxDepth(options.maxDepth);
+        builder->setTextOutput(!options.useJSON && !options.binaryOutput);
+        return builder;
+    }
+    
     return createBuilder(targetPath, 
                         options.useJSON,
                         options.maxDepth,
@@ -6,6 +6,8 @@
 #include "JSONTreeBuilder.h"
 #include "MultiThreadedTreeBuilder.h"
 #include "GitHubTreeBuilder.h"
+#include "WatchTreeBuilder.h"
+#include "ModelTreeBuilder.h"
 #include "CommandLineParser.h"
 
 class BuilderFactory {
@@ -14,6 +16,9 @@ public:
     static void applySettings(const CommandLineOptions& options, TreeBuilder& builder);
     
 private:
+    // Одного специализированного построителя мало: сочетание --json, фильтров,
+    // -L и потоков, второй формат вывода (--json-output) или --format bin
+    static bool needsModel(const CommandLineOptions& options);
     static std::unique_ptr<TreeBuilder> createBuilder(const std::string& path, 
                                                      bool useJSON = false,
                                                      size_t maxDepth = 0,
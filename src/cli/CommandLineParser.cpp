@@ -22,6 +22,8 @@ bool CommandLineParser::parser(int argc, char* argv[], CommandLineOptions& optio
             return false;
         } else if (arg == "-a" || arg == "--all") {
             options.showHidden = true;
+        } else if (arg == "--gitignore") {
+            options.gitignore = true;
         } else if (arg == "-D" || arg == "--directories-only") {
             options.directoriesOnly = true;
             options.useFilteredBuilder = true;
@@ -32,6 +34,51 @@ bool CommandLineParser::parser(int argc, char* argv[], CommandLineOptions& optio
             options.useJSON = true;
             ColorManager::disableColors();
             options.noColor = true;
+        } else if (arg == "--ndjson") {
+            options.ndjson = true;
+            ColorManager::disableColors();
+            options.noColor = true;
+        } else if (arg == "--compact") {
+            options.compactJSON = true;
+        } else if (arg == "--summary") {
+            options.depthSummary = true;
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--watch") {
+            options.watch = true;
+        } else if (arg == "--watch-delta") {
+            options.watch = true;
+            options.watchDelta = true;
+        } else if (arg == "--index") {
+            if (i + 1 < argc) {
+                options.indexPath = argv[++i];
+            } else {
+                std::cerr << "Ошибка: отсутствует имя файла для опции --index" << std::endl;
+                return false;
+            }
+        } else if (arg == "--uring-depth") {
+            if (i + 1 < argc) {
+                try {
+                    unsigned long depth = std::stoul(argv[++i]);
+                    if (depth > MAX_URING_DEPTH) {
+                        throw std::out_of_range("uring depth");
+                    }
+                    options.uringDepth = static_cast<unsigned>(depth);
+                } catch (...) {
+                    std::cerr << "Ошибка: глубина очереди должна быть от 0 до " << MAX_URING_DEPTH << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "Ошибка: отсутствует глубина для опции --uring-depth" << std::endl;
+                return false;
+            }
+        } else if (arg == "--synthetic") {
+            if (i + 1 < argc) {
+                options.syntheticSpec = argv[++i];
+            } else {
+                std::cerr << "Ошибка: отсутствует спецификация для опции --synthetic" << std::endl;
+                return false;
+            }
         } else if (arg == "-o" || arg == "--output") {
             if (i + 1 < argc) {
                 options.outputFile = argv[++i];
@@ -41,6 +88,32 @@ bool CommandLineParser::parser(int argc, char* argv[], CommandLineOptions& optio
                 std::cerr << "Ошибка: отсутствует имя файла для опции -o" << std::endl;
                 return false;
             }
+        } else if (arg == "--format") {
+            std::string format = i + 1 < argc ? argv[++i] : "";
+            if (format == "json") {
+                options.useJSON = true;
+                ColorManager::disableColors();
+                options.noColor = true;
+            } else if (format == "bin") {
+                options.binaryOutput = true;
+            } else if (format != "text") {
+                std::cerr << "Ошибка: неизвестный формат '" << format << "' (text, json, bin)" << std::endl;
+                return false;
+            }
+        } else if (arg == "--load") {
+            if (i + 1 < argc) {
+                options.loadFile = argv[++i];
+            } else {
+                std::cerr << "Ошибка: отсутствует имя файла для опции --load" << std::endl;
+                return false;
+            }
+        } else if (arg == "--json-output") {
+            if (i + 1 < argc) {
+                options.jsonOutputFile = argv[++i];
+            } else {
+                std::cerr << "Ошибка: отсутствует имя файла для опции --json-output" << std::endl;
+                return false;
+            }
         } else if (arg == "-L" || arg == "--level") {
             if (i + 1 < argc) {
                 try {
@@ -62,12 +135,12 @@ bool CommandLineParser::parser(int argc, char* argv[], CommandLineOptions& optio
             }
         } else if (arg == "-n" || arg == "--name") {
             if (i + 1 < argc) {
-                options.nameFilter = argv[++i];
+                options.nameFilters.push_back(argv[++i]);
                 options.useFilteredBuilder = true;
             }
         } else if (arg == "-x" || arg == "--exclude") {
             if (i + 1 < argc) {
-                options.excludeFilter = argv[++i];
+                options.excludeFilters.push_back(argv[++i]);
                 options.useFilteredBuilder = true;
             }
         } else if (arg == "-t" || arg == "--threads") {
@@ -111,6 +184,66 @@ bool CommandLineParser::parser(int argc, char* argv[], CommandLineOptions& optio
         }
     }
     
+    if (options.watch && (options.useJSON || options.isGitHub || options.useFilteredBuilder ||
+                          options.maxDepth > 0 || !options.outputFile.empty() ||
+                          !options.jsonOutputFile.empty())) {
+        std::cerr << "Ошибка: --watch несовместим с --json, --json-output, -o, -g, -L и фильтрами" << std::endl;
+        return false;
+    }
+    
+    if (options.binaryOutput && options.outputFile.empty()) {
+        std::cerr << "Ошибка: --format bin требует -o FILE" << std::endl;
+        return false;
+    }
+    
+    if (options.binaryOutput && (options.useJSON || options.isGitHub || options.watch || !options.loadFile.empty())) {
+        std::cerr << "Ошибка: --format bin несовместим с --json, -g, --watch и --load" << std::endl;
+        return false;
+    }
+    
+    if (!options.loadFile.empty() && (options.isGitHub || options.watch || options.useFilteredBuilder ||
+                                      options.maxDepth > 0 || options.threadCount != 1 ||
+                                      !options.jsonOutputFile.empty())) {
+        std::cerr << "Ошибка: --load несовместим с -g, --watch, -L, -t, --json-output и фильтрами" << std::endl;
+        return false;
+    }
+    
+    if (options.ndjson && (options.useJSON || options.binaryOutput || options.isGitHub || options.watch ||
+                           !options.loadFile.empty() || !options.jsonOutputFile.empty() ||
+                           options.useFilteredBuilder)) {
+        std::cerr << "Ошибка: --ndjson несовместим с --json, --format bin, -g, --watch, --load, "
+                  << "--json-output и фильтрами" << std::endl;
+        return false;
+    }
+    
+    if (options.depthSummary && options.maxDepth == 0) {
+        std::cerr << "Ошибка: --summary используется только с -L" << std::endl;
+        return false;
+    }
+    
+    if (options.depthSummary && (options.useJSON || options.ndjson || options.binaryOutput || options.isGitHub ||
+                                 options.watch || !options.loadFile.empty() || !options.jsonOutputFile.empty() ||
+                                 options.useFilteredBuilder)) {
+        std::cerr << "Ошибка: --summary несовместим с --json, --ndjson, --format bin, -g, --watch, --load, "
+                  << "--json-output и фильтрами" << std::endl;
+        return false;
+    }
+    
+    if (options.gitignore && (options.isGitHub || !options.loadFile.empty())) {
+        std::cerr << "Ошибка: --gitignore несовместим с -g и --load" << std::endl;
+        return false;
+    }
+    
+    if (options.compactJSON && !options.useJSON && options.jsonOutputFile.empty()) {
+        std::cerr << "Ошибка: --compact используется только с --json или --json-output" << std::endl;
+        return false;
+    }
+    
+    if (options.isGitHub && !options.jsonOutputFile.empty()) {
+        std::cerr << "Ошибка: --json-output недоступен для GitHub репозиториев" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
@@ -118,10 +251,14 @@ void CommandLineParser::applyFilters(CommandLineOptions& options, TreeBuilder& b
     if (!options.useFilteredBuilder) return;
     
     if (auto filteredBuilder = dynamic_cast<FilteredTreeBuilder*>(&builder)) {
+        // JSON в stdout не должен перемешиваться с сообщениями
+        std::ostream& log = options.useJSON ? std::cerr : std::cout;
+        filteredBuilder->setLog(log);
+        
         // Фильтр только директорий
         if (options.directoriesOnly) {
             filteredBuilder->setDirectoriesOnly(true);
-            std::cout << "Режим: отображаются только директории" << std::endl;
+            log << "Режим: отображаются только директории" << std::endl;
         }
         
         // Фильтр по размеру
@@ -153,7 +290,7 @@ void CommandLineParser::applyFilters(CommandLineOptions& options, TreeBuilder& b
             uint64_t size = parseSize(sizeStr);
             if (size > 0) {
                 filteredBuilder->addSizeFilter(size, operation);
-                std::cout << "Применен фильтр размера: " << operation << " " 
+                log << "Применен фильтр размера: " << operation << " " 
                           << FileSystem::formatSize(size) << std::endl;
             }
         }
@@ -187,14 +324,12 @@ void CommandLineParser::applyFilters(CommandLineOptions& options, TreeBuilder& b
             filteredBuilder->addDateFilter(dateStr, operation);
         }
         
-        // Фильтр по имени (включение)
-        if (!options.nameFilter.empty()) {
-            filteredBuilder->addNameFilter(options.nameFilter, true);
+        // Фильтры по имени: включение и исключение
+        for (const auto& pattern : options.nameFilters) {
+            filteredBuilder->addNameFilter(pattern, true);
         }
-        
-        // Фильтр по имени (исключение)
-        if (!options.excludeFilter.empty()) {
-            filteredBuilder->addNameFilter(options.excludeFilter, false);
+        for (const auto& pattern : options.excludeFilters) {
+            filteredBuilder->addNameFilter(pattern, false);
         }
     }
 }
@@ -1,29 +1,56 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <vector>
 #include "TreeBuilder.h"
+#include "FileSystemProvider.h"
 
 struct CommandLineOptions {
     std::string path = ".";
     bool showHidden = false;
+    // Не показывать и не обходить то, что игнорируют .gitignore и .ignore
+    bool gitignore = false;
     bool showHelp = false;
     bool showVersion = false;
     bool noColor = false;
     size_t maxDepth = 0;
     bool useJSON = false;
     std::string outputFile;
+    // JSON того же сканирования дополнительно к основному выводу
+    std::string jsonOutputFile;
+    // JSON без отступов и переводов строк
+    bool compactJSON = false;
+    // Плоский поток JSON-записей, по одной на элемент
+    bool ndjson = false;
+    // Двоичный формат дерева (--format bin) в файл -o
+    bool binaryOutput = false;
+    // Вывод дерева из двоичного файла вместо обхода
+    std::string loadFile;
+    // Итоги поддеревьев за границей -L вместо "(содержимое скрыто)"
+    bool depthSummary = false;
     bool useFilteredBuilder = false;
     bool isGitHub = false;
     std::string githubUrl;
     size_t githubDepth = 3;
     size_t threadCount = 1;
     bool directoriesOnly = false; 
+    bool profile = false;
+    // Спецификация синтетического дерева в памяти вместо файловой системы
+    std::string syntheticSpec;
+    // Файл постоянного индекса сканирования
+    std::string indexPath;
+    // Глубина очереди io_uring для пачек statx; 0 - синхронный statx
+    unsigned uringDepth = PosixFileSystemProvider::DEFAULT_QUEUE_DEPTH;
+    // Наблюдение за изменениями: перерисовка дерева или только изменения
+    bool watch = false;
+    bool watchDelta = false;
     
     // Фильтры
     std::string sizeFilter;
     std::string dateFilter;
-    std::string nameFilter;
-    std::string excludeFilter;
+    // -n и -x можно повторять
+    std::vector<std::string> nameFilters;
+    std::vector<std::string> excludeFilters;
 };
 
 class CommandLineParser {
@@ -31,5 +58,6 @@ public:
     static bool parser(int argc, char* argv[], CommandLineOptions& options, std::unique_ptr<TreeBuilder>& builder);
     static void applyFilters(CommandLineOptions& options, TreeBuilder& builder);
 private:
+    static constexpr unsigned long MAX_URING_DEPTH = 4096;
     static uint64_t parseSize(const std::string& sizeStr);
 };
\ No newline at end of file
@@ -1,7 +1,18 @@
 #include "OutputManager.h"
 #include "JSONTreeBuilder.h"
 #include "MultiThreadedTreeBuilder.h"
+#include "ModelTreeBuilder.h"
+#include "ArchiveTreeBuilder.h"
+#include "NDJSONTreeBuilder.h"
+#include "DepthViewTreeBuilder.h"
+#include "LineRenderer.h"
 #include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <ctime>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
 
 void OutputManager::printHelp() {
     std::cout << "Tree Utility v" << constants::VERSION << std::endl;
@@ -10,31 +21,64 @@ void OutputManager::printHelp() {
     std::cout << "Опции:" << std::endl;
     std::cout << "  -h, --help          Показать эту справку" << std::endl;
     std::cout << "  -a, --all           Показать скрытые файлы и папки" << std::endl;
+    std::cout << "  --gitignore         Пропускать игнорируемое .gitignore/.ignore и .git (не обходится)" << std::endl;
     std::cout << "  -v, --version       Показать версию" << std::endl;
     std::cout << "  -L, --level N       Ограничить глубину дерева N уровнями" << std::endl;
-    std::cout << "  -D, --directories-only Показать только директории" << std::endl;  
+    std::cout << "  -D, --directories-only Показать только директории" << std::endl;
+    std::cout << "  --summary           С -L: файлы, директории и размер скрытых поддеревьев" << std::endl;
+    std::cout << "                      (поддеревья считаются в -t потоков)" << std::endl;  
     std::cout << "  -s, --size OP SIZE  Фильтр по размеру (>, <, ==, >=, <=)" << std::endl;
-    std::cout << "  -d, --date OP DATE  Фильтр по дате (>, <, ==), формат: YYYY-MM-DD" << std::endl;
-    std::cout << "  -n, --name PATTERN  Включить файлы по шаблону имени" << std::endl;
-    std::cout << "  -x, --exclude PATTERN Исключить файлы по шаблону имени" << std::endl;
+    std::cout << "  -d, --date OP DATE  Фильтр по дате (>, <, ==, >=, <=), формат: YYYY-MM-DD[ HH:MM:SS]" << std::endl;
+    std::cout << "                      или возраст: 30s, 15m, 12h, 7d, 2w (\"< 7d\" - за последние 7 дней)" << std::endl;
+    std::cout << "  -n, --name PATTERN  Включить файлы по шаблону имени (* и ?, можно повторять)" << std::endl;
+    std::cout << "  -x, --exclude PATTERN Исключить файлы по шаблону имени (можно повторять)," << std::endl;
+    std::cout << "                      PATTERN/ - директории, они не обходятся" << std::endl;
     std::cout << "  --no-color          Отключить цветное оформление" << std::endl;
+    std::cout << "                      (цвета файлов можно задать через LS_COLORS)" << std::endl;
     std::cout << "  --json              Вывод в формате JSON" << std::endl;
+    std::cout << "  --compact           JSON в одну строку, без отступов" << std::endl;
+    std::cout << "  --ndjson            По JSON-записи в строке на элемент (path, depth, type, size, mtime, mode)" << std::endl;
     std::cout << "  -g, --github URL    Построить дерево из GitHub репозитория" << std::endl;
     std::cout << "  --github-depth N    Глубина для GitHub (по умолчанию: 3)" << std::endl;
     std::cout << "  -o, --output FILE   Сохранить вывод в файл" << std::endl;
+    std::cout << "  --json-output FILE  Дополнительно сохранить JSON того же сканирования" << std::endl;
+    std::cout << "  --format FMT        Формат вывода: text, json или bin (bin - только в файл -o)" << std::endl;
+    std::cout << "  --load FILE         Вывести дерево из файла --format bin без обхода диска" << std::endl;
     std::cout << "  -t, --threads N     Количество потоков (auto, 1, 2, 4, ...)" << std::endl;
+    std::cout << "  --profile           Время по фазам и счетчики построения (в stderr)" << std::endl;
+    std::cout << "  --watch             Следить за изменениями (inotify) и перерисовывать дерево" << std::endl;
+    std::cout << "  --watch-delta       Следить за изменениями и выводить только их" << std::endl;
+    std::cout << "  --index FILE        Индекс сканирования: неизмененные директории (по mtime)" << std::endl;
+    std::cout << "                      не перечитываются при следующем запуске" << std::endl;
+    std::cout << "  --uring-depth N     Глубина очереди io_uring для пакетного statx (по умолчанию: 64," << std::endl;
+    std::cout << "                      0 - без io_uring); без поддержки ядра - обычный statx" << std::endl;
+    std::cout << "  --synthetic SPEC    Обойти синтетическое дерево в памяти, смонтированное в ПУТЬ" << std::endl;
+    std::cout << "                      (fanout=4,depth=4,files=16,size=1K-1M,name=8-16,latency=0us,seed=1)" << std::endl;
     std::cout << std::endl;
     std::cout << "Примеры:" << std::endl;
     std::cout << "  tree-utility . -L 2           # Показать дерево глубиной 2 уровня" << std::endl;
     std::cout << "  tree-utility . -a -L 3" << std::endl;
+    std::cout << "  tree-utility /data -L 1 --summary -t auto # Обзор размеров, как du" << std::endl;
     std::cout << "  tree-utility . -s \"> 100MB\"   # Файлы > 100MB" << std::endl;
     std::cout << "  tree-utility . -d \"> 2023-01-01\" # Файлы после 2023-01-01" << std::endl;
+    std::cout << "  tree-utility . -d \"< 7d\"       # Измененные за неделю" << std::endl;
+    std::cout << "  tree-utility ~/src/project --gitignore # Без node_modules, build и .git" << std::endl;
     std::cout << "  tree-utility . -n \"*.cpp\"      # Только .cpp файлы" << std::endl;
     std::cout << "  tree-utility . -x \"test.*\"     # Исключить test файлы" << std::endl;
+    std::cout << "  tree-utility . -n \"*.cpp\" -n \"*.h\" -x \"*_test.*\" # Исходники без тестов" << std::endl;
+    std::cout << "  tree-utility . -n \"*.log\" -x \"node_modules/\" -x \".git/\" # Логи, не заходя в node_modules и .git" << std::endl;
     std::cout << "  tree-utility . --json         # Вывод в формате JSON" << std::endl;
     std::cout << "  tree-utility . --json -o output.json # Сохранить в JSON файл" << std::endl;
+    std::cout << "  tree-utility . -t 4 --json-output tree.json # Дерево на экран и JSON за один обход" << std::endl;
+    std::cout << "  tree-utility . --format bin -o tree.bin # Компактный двоичный формат" << std::endl;
+    std::cout << "  tree-utility --load tree.bin --json # Сохраненное дерево в JSON" << std::endl;
+    std::cout << "  tree-utility /data --ndjson -t 8 | jq -c 'select(.size > 1000000)'" << std::endl;
     std::cout << "  tree-utility . -t auto        # Автоматическое определение потоков" << std::endl;
     std::cout << "  tree-utility . -t 4           # Использовать 4 потока" << std::endl;
+    std::cout << "  tree-utility . --profile      # Где тратится время построения" << std::endl;
+    std::cout << "  tree-utility /var/log --watch-delta # Строки +, - и ~ по мере изменений" << std::endl;
+    std::cout << "  tree-utility /data --index ~/.cache/data.idx # Повторный запуск по индексу" << std::endl;
+    std::cout << "  tree-utility /nfs --synthetic fanout=8,depth=3,latency=2ms --profile" << std::endl;
 }
 
 void OutputManager::printVersion() {
@@ -79,28 +123,47 @@ void OutputManager::printStatistics(std::ostream& output, const TreeBuilder& bui
         output << "  Общий размер: " << FileSystem::formatSizeBothSystems(stats.totalSize) << std::endl;
     }
     
+    if (displayStats.metadataSyscalls > 0) {
+        size_t objects = displayStats.displayedFiles + displayStats.displayedDirectories;
+        output << "  Системных вызовов stat: " << displayStats.metadataSyscalls;
+        if (objects > 0) {
+            std::ostringstream perObject;
+            perObject << std::fixed << std::setprecision(2) 
+                      << static_cast<double>(displayStats.metadataSyscalls) / objects;
+            output << " (" << perObject.str() << " на объект)";
+        }
+        output << std::endl;
+    }
+    
     if (displayStats.hiddenObjects > 0 && !options.showHidden) {
         output << "  В каталоге есть скрытые объекты: " << displayStats.hiddenObjects 
                << " (используйте -a для показа)" << std::endl;
     }
+    if (displayStats.ignoredObjects > 0) {
+        output << "  Пропущено по .gitignore: " << displayStats.ignoredObjects << std::endl;
+    }
     
     if (options.useFilteredBuilder) {
         output << "  (Применены фильтры)" << std::endl;
     }
     
-    if (auto multiThreadedBuilder = dynamic_cast<const MultiThreadedTreeBuilder*>(&builder)) {
+    auto modelBuilder = dynamic_cast<const ModelTreeBuilder*>(&builder);
+    auto ndjsonBuilder = dynamic_cast<const NDJSONTreeBuilder*>(&builder);
+    auto depthBuilder = dynamic_cast<const DepthViewTreeBuilder*>(&builder);
+    if (dynamic_cast<const MultiThreadedTreeBuilder*>(&builder) || (modelBuilder && modelBuilder->isMultiThreaded()) ||
+        (ndjsonBuilder && ndjsonBuilder->isMultiThreaded()) || (depthBuilder && depthBuilder->isMultiThreaded())) {
         output << "  (Многопоточный режим)" << std::endl;
     }
 }
 
-bool OutputManager::outputToFile(const std::string& filename, const TreeBuilder& builder, 
+bool OutputManager::outputToFile(const std::string& filename, TreeBuilder& builder, 
                                 const CommandLineOptions& options) {
     bool wereColorsEnabled = ColorManager::areColorsEnabled();
     if (wereColorsEnabled) {
         ColorManager::disableColors();
     }
     
-    std::ofstream outFile(filename);
+    std::ofstream outFile(filename, options.binaryOutput ? std::ios::out | std::ios::binary : std::ios::out);
     if (!outFile) {
         std::cerr << "Ошибка: не удалось открыть файл " << filename << " для записи" << std::endl;
         if (wereColorsEnabled) {
@@ -109,21 +172,43 @@ bool OutputManager::outputToFile(const std::string& filename, const TreeBuilder&
         return false;
     }
 
+    if (options.useJSON && !providesJSON(builder)) {
+        std::cerr << "Ошибка: JSON builder не доступен" << std::endl;
+        if (wereColorsEnabled) {
+            ColorManager::enableColors();
+        }
+        return false;
+    }
+    
+    if (options.profile) {
+        Profiler::start();
+    }
+    
+    uint64_t bytesWritten = 0;
     if (options.useJSON) {
-        if (auto jsonBuilder = dynamic_cast<const JSONTreeBuilder*>(&builder)) {
-            outFile << jsonBuilder->getJSON() << std::endl;
-        } else {
-            std::cerr << "Ошибка: JSON builder не доступен" << std::endl;
+        bytesWritten = buildJSON(outFile, builder, options);
+    } else if (options.binaryOutput) {
+        builder.buildTree(options.showHidden);
+        auto modelBuilder = dynamic_cast<const ModelTreeBuilder*>(&builder);
+        if (!modelBuilder || !modelBuilder->writeArchive(outFile)) {
+            std::cerr << "Ошибка: не удалось записать " << filename << std::endl;
             if (wereColorsEnabled) {
                 ColorManager::enableColors();
             }
             return false;
         }
+        bytesWritten = static_cast<uint64_t>(outFile.tellp());
     } else {
-        const auto& treeLines = builder.getTreeLines();
-        for (const auto& line : treeLines) {
-            outFile << line << std::endl;
-        }
+        StreamSink sink(outFile);
+        builder.setOutputSink(&sink);
+        builder.buildTree(options.showHidden);
+        builder.setOutputSink(nullptr);
+        sink.flush();
+        bytesWritten = sink.bytesWritten();
+    }
+    
+    if (options.profile) {
+        printProfile(std::cerr, builder, options, Profiler::stop(), bytesWritten);
     }
     
     if (wereColorsEnabled) {
@@ -138,14 +223,239 @@ bool OutputManager::outputToFile(const std::string& filename, const TreeBuilder&
     return true;
 }
 
-void OutputManager::outputToConsole(const TreeBuilder& builder, const CommandLineOptions& options) {
-    if (options.maxDepth > 0 && !options.useJSON) {
+void OutputManager::outputToConsole(TreeBuilder& builder, const CommandLineOptions& options) {
+    // В stdout - только данные, если это JSON или NDJSON
+    bool dataOnly = options.useJSON || options.ndjson;
+    if (options.maxDepth > 0 && !dataOnly) {
         std::cout << "Глубина ограничена " << options.maxDepth << " уровнями" << std::endl;
     }
     
-    builder.printTree();
+    if (options.profile) {
+        Profiler::start();
+    }
     
-    if (!options.useJSON) {
+    uint64_t bytesWritten = 0;
+    if (options.useJSON && providesJSON(builder)) {
+        bytesWritten = buildJSON(std::cout, builder, options);
+    } else {
+        StreamSink sink(std::cout);
+        builder.setOutputSink(&sink);
+        builder.buildTree(options.showHidden);
+        builder.setOutputSink(nullptr);
+        sink.flush();
+        bytesWritten = sink.bytesWritten();
+        
+        // Строки уже выведены через sink, остается сброс цвета
+        builder.printTree();
+    }
+    
+    if (options.profile) {
+        printProfile(std::cerr, builder, options, Profiler::stop(), bytesWritten);
+    }
+    
+    if (!dataOnly) {
         printStatistics(std::cout, builder, options);
     }
-}
\ No newline at end of file
+}
+
+bool OutputManager::saveJSON(const std::string& filename, const TreeBuilder& builder,
+                             const CommandLineOptions& options) {
+    auto modelBuilder = dynamic_cast<const ModelTreeBuilder*>(&builder);
+    if (!modelBuilder) {
+        std::cerr << "Ошибка: JSON builder не доступен" << std::endl;
+        return false;
+    }
+    
+    std::ofstream outFile(filename);
+    if (!outFile) {
+        std::cerr << "Ошибка: не удалось открыть файл " << filename << " для записи" << std::endl;
+        return false;
+    }
+    {
+        JSONWriter writer(outFile, options.compactJSON);
+        modelBuilder->writeJSON(writer);
+    }
+    outFile << std::endl;
+    
+    std::cout << "JSON сохранен в файл: " << filename << std::endl;
+    return true;
+}
+
+bool OutputManager::providesJSON(const TreeBuilder& builder) {
+    return dynamic_cast<const JSONTreeBuilder*>(&builder) || dynamic_cast<const ModelTreeBuilder*>(&builder) ||
+           dynamic_cast<const ArchiveTreeBuilder*>(&builder);
+}
+
+uint64_t OutputManager::buildJSON(std::ostream& output, TreeBuilder& builder,
+                                  const CommandLineOptions& options) {
+    JSONWriter writer(output, options.compactJSON);
+    if (auto jsonBuilder = dynamic_cast<JSONTreeBuilder*>(&builder)) {
+        // Узлы уходят в поток прямо во время обхода
+        jsonBuilder->setJSONWriter(&writer);
+        builder.buildTree(options.showHidden);
+        jsonBuilder->setJSONWriter(nullptr);
+    } else if (auto modelBuilder = dynamic_cast<ModelTreeBuilder*>(&builder)) {
+        builder.buildTree(options.showHidden);
+        modelBuilder->writeJSON(writer);
+    } else if (auto archiveBuilder = dynamic_cast<ArchiveTreeBuilder*>(&builder)) {
+        builder.buildTree(options.showHidden);
+        archiveBuilder->writeJSON(writer);
+    }
+    writer.finish();
+    output << std::endl;
+    return writer.bytesWritten() + 1;
+}
+
+bool OutputManager::watchConsole(WatchTreeBuilder& builder, const CommandLineOptions& options) {
+    std::vector<WatchTreeBuilder::Change> changes;
+    bool watching = false;
+    
+    while (builder.waitForChanges(changes)) {
+        watching = true;
+        if (changes.empty() && !builder.wasFullRefresh()) {
+            continue;
+        }
+        
+        if (options.watchDelta) {
+            if (builder.wasFullRefresh()) {
+                std::cout << "* полное пересканирование (переполнение очереди inotify)" << '\n';
+            }
+            std::string line;
+            for (const auto& change : changes) {
+                switch (change.kind) {
+                    case WatchTreeBuilder::Change::Kind::ADDED: line = "+ "; break;
+                    case WatchTreeBuilder::Change::Kind::REMOVED: line = "- "; break;
+                    case WatchTreeBuilder::Change::Kind::MODIFIED: line = "~ "; break;
+                }
+                FileSystem::FileInfo info = change.info;
+                info.name = change.relativePath;
+                LineRenderer::appendEntry(line, info);
+                std::cout << line << ColorManager::getReset() << '\n';
+            }
+            auto stats = builder.getStatistics();
+            std::cout << "  Директорий: " << stats.totalDirectories
+                      << ", файлов: " << stats.totalFiles
+                      << ", размер: " << FileSystem::formatSizeBothSystems(stats.totalSize) << std::endl;
+        } else {
+            std::time_t now = std::time(nullptr);
+            std::cout << std::endl << "Обновлено " << FileSystem::formatTime(now)
+                      << ", изменений: " << changes.size()
+                      << (builder.wasFullRefresh() ? " (полное пересканирование)" : "") << std::endl;
+            StreamSink sink(std::cout);
+            builder.setOutputSink(&sink);
+            builder.renderTree();
+            builder.setOutputSink(nullptr);
+            sink.flush();
+            builder.printTree();
+            printStatistics(std::cout, builder, options);
+        }
+        changes.clear();
+    }
+    
+    if (!watching) {
+        std::cerr << "Ошибка: наблюдение за изменениями недоступно" << std::endl;
+    }
+    return watching;
+}
+
+namespace {
+    double toMilliseconds(uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    }
+    
+    json phasesToJSON(const Profiler::PhaseTotals* phases) {
+        json result = json::object();
+        for (size_t i = 0; i < Profiler::PHASE_COUNT; ++i) {
+            if (phases[i].calls == 0) {
+                continue;
+            }
+            result[Profiler::phaseName(static_cast<Profiler::Phase>(i))] = {
+                {"wallMs", toMilliseconds(phases[i].wallNs)},
+                {"cpuMs", toMilliseconds(phases[i].cpuNs)},
+                {"calls", phases[i].calls}
+            };
+        }
+        return result;
+    }
+    
+    void printPhases(std::ostream& output, const Profiler::PhaseTotals* phases, const std::string& indent) {
+        for (size_t i = 0; i < Profiler::PHASE_COUNT; ++i) {
+            if (phases[i].calls == 0) {
+                continue;
+            }
+            output << indent << std::left << std::setw(10) << Profiler::phaseName(static_cast<Profiler::Phase>(i))
+                   << std::right << std::setw(12) << toMilliseconds(phases[i].wallNs)
+                   << std::setw(12) << toMilliseconds(phases[i].cpuNs)
+                   << std::setw(12) << phases[i].calls << std::endl;
+        }
+    }
+}
+
+void OutputManager::printProfile(std::ostream& output, const TreeBuilder& builder,
+                                 const CommandLineOptions& options,
+                                 const Profiler::Report& report, uint64_t bytesWritten) {
+    auto displayStats = builder.getDisplayStatistics();
+    uint64_t entries = displayStats.displayedFiles + displayStats.displayedDirectories;
+    double seconds = static_cast<double>(report.wallNs) / 1e9;
+    double entriesPerSecond = seconds > 0 ? entries / seconds : 0.0;
+    double allocationsPerEntry = entries > 0 ? static_cast<double>(report.allocations) / entries : 0.0;
+    
+    if (options.useJSON) {
+        json threads = json::array();
+        for (const auto& thread : report.threads) {
+            threads.push_back({
+                {"name", thread.name},
+                {"phases", phasesToJSON(thread.phases)}
+            });
+        }
+        
+        json profile = {
+            {"wallMs", toMilliseconds(report.wallNs)},
+            {"cpuMs", toMilliseconds(report.cpuNs)},
+            {"entries", entries},
+            {"entriesPerSecond", entriesPerSecond},
+            {"syscalls", {
+                {"stat", report.statSyscalls},
+                {"readdir", report.readdirSyscalls}
+            }},
+            {"statBatching", PosixFileSystemProvider::isBatchingActive() ? "io_uring" : "sync"},
+            {"bytesWritten", bytesWritten},
+            {"peakRssKb", report.peakRssKb},
+            {"allocations", report.allocations},
+            {"allocationsPerEntry", allocationsPerEntry},
+            {"phases", phasesToJSON(report.phases)},
+            {"threads", threads}
+        };
+        output << json{{"profile", profile}}.dump(2) << std::endl;
+        return;
+    }
+    
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    text << std::endl;
+    text << "Профиль:" << std::endl;
+    text << "  Время: " << toMilliseconds(report.wallNs) << " мс, CPU: " 
+         << toMilliseconds(report.cpuNs) << " мс" << std::endl;
+    text << "  Объектов: " << entries << " (" << entriesPerSecond << " в секунду)" << std::endl;
+    text << "  Системных вызовов: stat " << report.statSyscalls 
+         << ", чтение каталогов " << report.readdirSyscalls << std::endl;
+    if (PosixFileSystemProvider::isBatchingActive()) {
+        text << "  Пакетный statx: io_uring, очередь " << PosixFileSystemProvider::getQueueDepth() << std::endl;
+    }
+    text << "  Записано байт: " << bytesWritten << std::endl;
+    text << "  Пиковый RSS: " << report.peakRssKb << " КиБ" << std::endl;
+    text << "  Выделений памяти: " << report.allocations 
+         << " (" << allocationsPerEntry << " на объект)" << std::endl;
+    text << "  Фаза         Время, мс     CPU, мс     Вызовов" << std::endl;
+    printPhases(text, report.phases, "  ");
+    
+    // Разбивка по потокам нужна, когда работало несколько потоков
+    if (report.threads.size() > 1) {
+        for (const auto& thread : report.threads) {
+            text << "  [" << thread.name << "]" << std::endl;
+            printPhases(text, thread.phases, "    ");
+        }
+    }
+    
+    output << text.str();
+}
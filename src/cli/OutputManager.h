@@ -4,6 +4,8 @@
 #include <memory>
 #include "TreeBuilder.h"
 #include "CommandLineParser.h"
+#include "Profiler.h"
+#include "WatchTreeBuilder.h"
 
 class OutputManager {
 public:
@@ -11,7 +13,24 @@ public:
     static void printVersion();
     static void printStatistics(std::ostream& output, const TreeBuilder& builder, 
                                const CommandLineOptions& options);   
-    static bool outputToFile(const std::string& filename, const TreeBuilder& builder, 
+    // Строят дерево, сразу направляя строки в файл или на консоль
+    static bool outputToFile(const std::string& filename, TreeBuilder& builder, 
                             const CommandLineOptions& options);
-    static void outputToConsole(const TreeBuilder& builder, const CommandLineOptions& options);
+    static void outputToConsole(TreeBuilder& builder, const CommandLineOptions& options);
+    // JSON уже построенного дерева в файл (--json-output): без повторного обхода
+    static bool saveJSON(const std::string& filename, const TreeBuilder& builder,
+                         const CommandLineOptions& options);
+    // Цикл --watch после первого вывода: перерисовка дерева или строки изменений
+    static bool watchConsole(WatchTreeBuilder& builder, const CommandLineOptions& options);
+    // Отчет --profile: текстом или JSON (при --json)
+    static void printProfile(std::ostream& output, const TreeBuilder& builder,
+                             const CommandLineOptions& options,
+                             const Profiler::Report& report, uint64_t bytesWritten);
+    
+private:
+    // JSON дают JSONTreeBuilder и ModelTreeBuilder
+    static bool providesJSON(const TreeBuilder& builder);
+    // Строит дерево и пишет его JSON в output; возвращает число записанных байт
+    static uint64_t buildJSON(std::ostream& output, TreeBuilder& builder,
+                              const CommandLineOptions& options);
 };
\ No newline at end of file
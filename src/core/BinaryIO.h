@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Запись и чтение двоичных файлов (индекс сканирования, экспорт дерева).
+// Числа - little-endian на любой машине, строки - с длиной uint32 впереди.
+// На little-endian машине перестановки байт нет, массивы копируются целиком.
+namespace binary {
+    constexpr bool HOST_LITTLE_ENDIAN = __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+    // Значение в порядке байт файла и обратно (преобразование симметрично)
+    template <typename T>
+    T littleEndian(T value) {
+        if constexpr (HOST_LITTLE_ENDIAN || sizeof(T) == 1 || !(std::is_integral_v<T> || std::is_enum_v<T>)) {
+            return value;
+        } else {
+            static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8, "неподдерживаемый размер числа");
+            using Bits = std::conditional_t<sizeof(T) == 2, uint16_t,
+                                            std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>;
+            Bits bits;
+            std::memcpy(&bits, &value, sizeof(T));
+            if constexpr (sizeof(T) == 2) {
+                bits = __builtin_bswap16(bits);
+            } else if constexpr (sizeof(T) == 4) {
+                bits = __builtin_bswap32(bits);
+            } else {
+                bits = __builtin_bswap64(bits);
+            }
+            std::memcpy(&value, &bits, sizeof(T));
+            return value;
+        }
+    }
+
+    template <typename T>
+    void put(std::string& out, T value) {
+        value = littleEndian(value);
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    inline void putString(std::string& out, std::string_view text) {
+        put<uint32_t>(out, static_cast<uint32_t>(text.size()));
+        out += text;
+    }
+
+    // Массив целиком, без длины: число элементов записывается отдельно
+    template <typename T>
+    void putArray(std::string& out, const std::vector<T>& values) {
+        if constexpr (HOST_LITTLE_ENDIAN || sizeof(T) == 1) {
+            out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+        } else {
+            for (const T& value : values) {
+                put(out, value);
+            }
+        }
+    }
+
+    // Чтение с проверкой границ: поврежденный файл не выходит за буфер
+    class Reader {
+    public:
+        explicit Reader(std::string_view data) : data_(data) {}
+
+        template <typename T>
+        bool get(T& value) {
+            if (data_.size() - pos_ < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, data_.data() + pos_, sizeof(T));
+            if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+                value = littleEndian(value);
+            }
+            pos_ += sizeof(T);
+            return true;
+        }
+
+        bool getString(std::string& text) {
+            uint32_t length = 0;
+            if (!get(length) || data_.size() - pos_ < length) {
+                return false;
+            }
+            text.assign(data_.data() + pos_, length);
+            pos_ += length;
+            return true;
+        }
+
+        // count элементов одним копированием
+        template <typename T>
+        bool getArray(std::vector<T>& values, size_t count) {
+            if ((data_.size() - pos_) / sizeof(T) < count) {
+                return false;
+            }
+            values.resize(count);
+            std::memcpy(values.data(), data_.data() + pos_, count * sizeof(T));
+            if constexpr (!HOST_LITTLE_ENDIAN && sizeof(T) > 1) {
+                for (T& value : values) {
+                    value = littleEndian(value);
+                }
+            }
+            pos_ += count * sizeof(T);
+            return true;
+        }
+
+        // Следующие length байт без копирования
+        bool getBytes(std::string_view& bytes, size_t length) {
+            if (data_.size() - pos_ < length) {
+                return false;
+            }
+            bytes = data_.substr(pos_, length);
+            pos_ += length;
+            return true;
+        }
+
+        size_t remaining() const { return data_.size() - pos_; }
+        bool atEnd() const { return pos_ == data_.size(); }
+
+    private:
+        std::string_view data_;
+        size_t pos_ = 0;
+    };
+}
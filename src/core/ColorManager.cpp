@@ -2,34 +2,38 @@
 
 bool ColorManager::colorsEnabled = true;
 
+namespace {
+    const std::string NO_COLOR;
+}
+
 void ColorManager::disableColors() { colorsEnabled = false; }
 void ColorManager::enableColors() { colorsEnabled = true; }
 bool ColorManager::areColorsEnabled() { return colorsEnabled; }
 
-std::string ColorManager::getDirNameColor() {
-    return colorsEnabled ? constants::DIR_NAME_COLOR : "";
+const std::string& ColorManager::getDirNameColor() {
+    return colorsEnabled ? constants::DIR_NAME_COLOR : NO_COLOR;
 }
 
-std::string ColorManager::getDirLabelColor() {
-    return colorsEnabled ? constants::DIR_LABEL_COLOR : "";
+const std::string& ColorManager::getDirLabelColor() {
+    return colorsEnabled ? constants::DIR_LABEL_COLOR : NO_COLOR;
 }
 
-std::string ColorManager::getSizeColor() {
-    return colorsEnabled ? constants::SIZE_COLOR : "";
+const std::string& ColorManager::getSizeColor() {
+    return colorsEnabled ? constants::SIZE_COLOR : NO_COLOR;
 }
 
-std::string ColorManager::getDateColor() {
-    return colorsEnabled ? constants::DATE_COLOR : "";
+const std::string& ColorManager::getDateColor() {
+    return colorsEnabled ? constants::DATE_COLOR : NO_COLOR;
 }
 
-std::string ColorManager::getPermissionsColor() {
-    return colorsEnabled ? constants::PERMISSIONS_COLOR : "";
+const std::string& ColorManager::getPermissionsColor() {
+    return colorsEnabled ? constants::PERMISSIONS_COLOR : NO_COLOR;
 }
 
-std::string ColorManager::getHiddenContentColor() {
-    return colorsEnabled ? constants::HIDDEN_CONTENT_COLOR : "";
+const std::string& ColorManager::getHiddenContentColor() {
+    return colorsEnabled ? constants::HIDDEN_CONTENT_COLOR : NO_COLOR;
 }
 
-std::string ColorManager::getReset() {
-    return colorsEnabled ? constants::RESET : "";
+const std::string& ColorManager::getReset() {
+    return colorsEnabled ? constants::RESET : NO_COLOR;
 }
\ No newline at end of file
@@ -8,13 +8,14 @@ public:
     static void enableColors();
     static bool areColorsEnabled();
     
-    static std::string getDirNameColor();
-    static std::string getDirLabelColor();
-    static std::string getSizeColor();
-    static std::string getDateColor();
-    static std::string getPermissionsColor();
-    static std::string getHiddenContentColor();
-    static std::string getReset();
+    // Ссылки на константы: вызовы в каждой строке дерева не копируют строки
+    static const std::string& getDirNameColor();
+    static const std::string& getDirLabelColor();
+    static const std::string& getSizeColor();
+    static const std::string& getDateColor();
+    static const std::string& getPermissionsColor();
+    static const std::string& getHiddenContentColor();
+    static const std::string& getReset();
     
 private:
     static bool colorsEnabled;
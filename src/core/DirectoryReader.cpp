@@ -0,0 +1,112 @@
+#include "DirectoryReader.h"
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace {
+    std::atomic<uint64_t> syscallCount{0};
+    
+    DirectoryReader::EntryType toEntryType(unsigned char dtype) {
+        switch (dtype) {
+            case DT_REG: return DirectoryReader::EntryType::REGULAR;
+            case DT_DIR: return DirectoryReader::EntryType::DIRECTORY;
+            case DT_LNK: return DirectoryReader::EntryType::SYMLINK;
+            case DT_UNKNOWN: return DirectoryReader::EntryType::UNKNOWN;
+            default: return DirectoryReader::EntryType::OTHER;
+        }
+    }
+
+    bool isDotOrDotDot(const char* name) {
+        return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+    }
+
+#ifdef __linux__
+    struct LinuxDirent64 {
+        uint64_t d_ino;
+        int64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[];
+    };
+#endif
+}
+
+#ifdef __linux__
+
+bool DirectoryReader::readEntries(const fs::path& path, std::vector<Entry>& entries) {
+    syscallCount.fetch_add(1, std::memory_order_relaxed);
+    int fd = ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Буфер на поток: рекурсивный обход не держит открытыми несколько каталогов
+    thread_local std::vector<char> buffer(BUFFER_SIZE);
+    bool ok = true;
+
+    while (true) {
+        syscallCount.fetch_add(1, std::memory_order_relaxed);
+        long bytes = ::syscall(SYS_getdents64, fd, buffer.data(), buffer.size());
+        if (bytes == 0) {
+            break;
+        }
+        if (bytes < 0) {
+            ok = false;
+            break;
+        }
+
+        for (long offset = 0; offset < bytes; ) {
+            auto* dirent = reinterpret_cast<LinuxDirent64*>(buffer.data() + offset);
+            offset += dirent->d_reclen;
+
+            if (isDotOrDotDot(dirent->d_name)) {
+                continue;
+            }
+
+            Entry entry;
+            entry.name.assign(dirent->d_name);
+            entry.type = toEntryType(dirent->d_type);
+            entry.inode = dirent->d_ino;
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    ::close(fd);
+    return ok;
+}
+
+#else
+
+bool DirectoryReader::readEntries(const fs::path& path, std::vector<Entry>& entries) {
+    syscallCount.fetch_add(1, std::memory_order_relaxed);
+    DIR* dir = ::opendir(path.c_str());
+    if (!dir) {
+        return false;
+    }
+
+    while (struct dirent* dirent = ::readdir(dir)) {
+        if (isDotOrDotDot(dirent->d_name)) {
+            continue;
+        }
+
+        Entry entry;
+        entry.name.assign(dirent->d_name);
+        entry.type = toEntryType(dirent->d_type);
+        entry.inode = dirent->d_ino;
+        entries.push_back(std::move(entry));
+    }
+
+    ::closedir(dir);
+    return true;
+}
+
+#endif
+
+uint64_t DirectoryReader::getSyscallCount() {
+    return syscallCount.load(std::memory_order_relaxed);
+}
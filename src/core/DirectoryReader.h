@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// Низкоуровневое чтение каталога пакетами getdents64.
+// Тип записи берется из d_type, поэтому для классификации stat не нужен.
+class DirectoryReader {
+public:
+    enum class EntryType { UNKNOWN, REGULAR, DIRECTORY, SYMLINK, OTHER };
+
+    struct Entry {
+        std::string name;
+        EntryType type = EntryType::UNKNOWN;
+        uint64_t inode = 0;
+    };
+
+    // Читает все записи каталога, кроме "." и "..".
+    // Возвращает false, если каталог не удалось открыть или прочитать.
+    static bool readEntries(const fs::path& path, std::vector<Entry>& entries);
+    
+    // Число системных вызовов открытия и чтения каталогов за время работы
+    static uint64_t getSyscallCount();
+
+    static constexpr size_t BUFFER_SIZE = 128 * 1024;
+};
@@ -0,0 +1,242 @@
+#include "FileColorTable.h"
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <string>
+
+namespace {
+    // ANSI-коды как string_view, чтобы таблица была constexpr
+    // (значения совпадают с constants::*)
+    namespace ansi {
+        constexpr std::string_view BLACK = "\033[30m";
+        constexpr std::string_view BLACK_BOLD = "\033[30m\033[1m";
+        constexpr std::string_view RED = "\033[31m";
+        constexpr std::string_view GREEN = "\033[32m";
+        constexpr std::string_view GREEN_BOLD = "\033[32m\033[1m";
+        constexpr std::string_view YELLOW = "\033[33m";
+        constexpr std::string_view BLUE_BOLD = "\033[34m\033[1m";
+        constexpr std::string_view MAGENTA = "\033[35m";
+        constexpr std::string_view MAGENTA_BOLD = "\033[35m\033[1m";
+        constexpr std::string_view CYAN = "\033[36m";
+        constexpr std::string_view CYAN_BOLD = "\033[36m\033[1m";
+        constexpr std::string_view WHITE = "\033[37m";
+    }
+
+    constexpr std::string_view IMAGE = ansi::MAGENTA;
+    constexpr std::string_view VIDEO = ansi::MAGENTA_BOLD;
+    constexpr std::string_view AUDIO = ansi::CYAN_BOLD;
+    constexpr std::string_view ARCHIVE = ansi::RED;
+    constexpr std::string_view CONFIG = ansi::YELLOW;
+    constexpr std::string_view DOCUMENT = ansi::WHITE;
+    constexpr std::string_view CODE = ansi::GREEN;
+    constexpr std::string_view DATA = ansi::YELLOW;
+    constexpr std::string_view BACKUP = ansi::BLACK;
+    constexpr std::string_view FONT = ansi::MAGENTA;
+
+    struct ColorRule {
+        std::string_view extension;
+        std::string_view color;
+    };
+
+    constexpr ColorRule BUILTIN_RULES[] = {
+        // Изображения
+        {"jpg", IMAGE}, {"jpeg", IMAGE}, {"png", IMAGE}, {"gif", IMAGE},
+        {"bmp", IMAGE}, {"svg", IMAGE}, {"webp", IMAGE}, {"tiff", IMAGE},
+        // Видео
+        {"mov", VIDEO}, {"mp4", VIDEO}, {"avi", VIDEO}, {"mkv", VIDEO}, {"wmv", VIDEO},
+        {"flv", VIDEO}, {"webm", VIDEO}, {"m4v", VIDEO}, {"mpeg", VIDEO},
+        // Аудио
+        {"mp3", AUDIO}, {"wav", AUDIO}, {"flac", AUDIO}, {"aac", AUDIO},
+        {"ogg", AUDIO}, {"wma", AUDIO},
+        // Архивы
+        {"zip", ARCHIVE}, {"rar", ARCHIVE}, {"tar", ARCHIVE}, {"gz", ARCHIVE}, {"7z", ARCHIVE},
+        {"bz2", ARCHIVE}, {"xz", ARCHIVE}, {"lz", ARCHIVE}, {"arj", ARCHIVE},
+        // Конфигурационные файлы
+        {"conf", CONFIG}, {"config", CONFIG}, {"ini", CONFIG}, {"json", CONFIG}, {"xml", CONFIG},
+        {"yaml", CONFIG}, {"yml", CONFIG}, {"toml", CONFIG}, {"properties", CONFIG},
+        // Документы
+        {"txt", DOCUMENT}, {"doc", DOCUMENT}, {"docx", DOCUMENT}, {"pdf", DOCUMENT},
+        {"rtf", DOCUMENT}, {"odt", DOCUMENT}, {"xls", DOCUMENT}, {"xlsx", DOCUMENT},
+        {"ppt", DOCUMENT}, {"pptx", DOCUMENT}, {"epub", DOCUMENT}, {"mobi", DOCUMENT},
+        // Исходный код
+        {"cpp", CODE}, {"h", CODE}, {"hpp", CODE}, {"c", CODE}, {"java", CODE}, {"py", CODE},
+        {"js", CODE}, {"html", CODE}, {"css", CODE}, {"php", CODE}, {"rb", CODE}, {"go", CODE},
+        {"rs", CODE}, {"swift", CODE}, {"kt", CODE}, {"ts", CODE}, {"scala", CODE}, {"pl", CODE},
+        {"lua", CODE}, {"sh", CODE}, {"bat", CODE}, {"ps1", CODE}, {"md", CODE}, {"tex", CODE},
+        // Базы данных и данные
+        {"db", DATA}, {"sql", DATA}, {"sqlite", DATA}, {"mdb", DATA},
+        {"csv", DATA}, {"tsv", DATA}, {"dat", DATA}, {"log", DATA},
+        // Файлы бэкапов
+        {"bak", BACKUP}, {"backup", BACKUP}, {"old", BACKUP}, {"tmp", BACKUP}, {"temp", BACKUP},
+        // Шрифты
+        {"ttf", FONT}, {"otf", FONT}, {"woff", FONT}, {"woff2", FONT}, {"eot", FONT},
+    };
+
+    // Запас мест под расширения из LS_COLORS; размер - степень двойки
+    constexpr size_t TABLE_SIZE = 1024;
+
+    struct Slot {
+        std::string_view extension;
+        std::string_view color;
+    };
+
+    using Table = std::array<Slot, TABLE_SIZE>;
+
+    constexpr uint32_t hashExtension(std::string_view extension) {
+        uint32_t hash = 2166136261u;
+        for (char c : extension) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    constexpr bool insertRule(Table& table, std::string_view extension, std::string_view color) {
+        size_t index = hashExtension(extension) & (TABLE_SIZE - 1);
+        for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+            Slot& slot = table[index];
+            if (slot.extension.empty() || slot.extension == extension) {
+                slot.extension = extension;
+                slot.color = color;
+                return true;
+            }
+            index = (index + 1) & (TABLE_SIZE - 1);
+        }
+        return false;
+    }
+
+    constexpr Table buildBuiltinTable() {
+        Table table{};
+        for (const auto& rule : BUILTIN_RULES) {
+            insertRule(table, rule.extension, rule.color);
+        }
+        return table;
+    }
+
+    constexpr Table BUILTIN_TABLE = buildBuiltinTable();
+
+    struct Scheme {
+        Table table = BUILTIN_TABLE;
+        std::string_view file = ansi::WHITE;
+        std::string_view directory = ansi::BLUE_BOLD;
+        std::string_view symlink = ansi::CYAN;
+        std::string_view executable = ansi::GREEN_BOLD;
+        std::string_view hidden = ansi::BLACK_BOLD;
+        // Строки из LS_COLORS; deque не перемещает элементы при добавлении
+        std::deque<std::string> storage;
+    };
+
+    Scheme activeScheme;
+
+    char toLowerAscii(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool isSgrSequence(std::string_view value) {
+        if (value.empty()) {
+            return false;
+        }
+        for (char c : value) {
+            if (!(c >= '0' && c <= '9') && c != ';') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string_view store(std::string text) {
+        activeScheme.storage.push_back(std::move(text));
+        return activeScheme.storage.back();
+    }
+}
+
+std::string_view FileColorTable::forFileName(std::string_view name) {
+    size_t dot = name.rfind('.');
+    if (dot == std::string_view::npos || dot + 1 == name.size() ||
+        name.size() - dot - 1 > MAX_EXTENSION_LENGTH) {
+        return activeScheme.file;
+    }
+
+    // Расширение приводится к нижнему регистру в буфере на стеке
+    char lower[MAX_EXTENSION_LENGTH];
+    size_t length = name.size() - dot - 1;
+    for (size_t i = 0; i < length; ++i) {
+        lower[i] = toLowerAscii(name[dot + 1 + i]);
+    }
+    std::string_view extension(lower, length);
+
+    size_t index = hashExtension(extension) & (TABLE_SIZE - 1);
+    for (size_t probe = 0; probe < TABLE_SIZE; ++probe) {
+        const Slot& slot = activeScheme.table[index];
+        if (slot.extension.empty()) {
+            break;
+        }
+        if (slot.extension == extension) {
+            return slot.color;
+        }
+        index = (index + 1) & (TABLE_SIZE - 1);
+    }
+    return activeScheme.file;
+}
+
+std::string_view FileColorTable::directory() { return activeScheme.directory; }
+std::string_view FileColorTable::symlink() { return activeScheme.symlink; }
+std::string_view FileColorTable::executable() { return activeScheme.executable; }
+std::string_view FileColorTable::hidden() { return activeScheme.hidden; }
+
+void FileColorTable::loadLsColors(std::string_view spec) {
+    while (!spec.empty()) {
+        size_t end = spec.find(':');
+        std::string_view item = spec.substr(0, end);
+        spec = end == std::string_view::npos ? std::string_view() : spec.substr(end + 1);
+
+        size_t eq = item.find('=');
+        if (eq == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = item.substr(0, eq);
+        std::string_view value = item.substr(eq + 1);
+
+        // Поддерживаются только коды SGR; значения вроде ln=target пропускаются
+        if (!isSgrSequence(value)) {
+            continue;
+        }
+        std::string_view color = store("\033[" + std::string(value) + "m");
+
+        if (key.size() > 2 && key[0] == '*' && key[1] == '.') {
+            std::string extension(key.substr(2));
+            if (extension.size() > MAX_EXTENSION_LENGTH) {
+                continue;
+            }
+            for (char& c : extension) {
+                c = toLowerAscii(c);
+            }
+            insertRule(activeScheme.table, store(std::move(extension)), color);
+        } else if (key == "fi") {
+            activeScheme.file = color;
+        } else if (key == "di") {
+            activeScheme.directory = color;
+        } else if (key == "ln") {
+            activeScheme.symlink = color;
+        } else if (key == "ex") {
+            activeScheme.executable = color;
+        }
+    }
+}
+
+void FileColorTable::loadFromEnvironment() {
+    if (const char* spec = std::getenv("LS_COLORS")) {
+        loadLsColors(spec);
+    }
+}
+
+void FileColorTable::reset() {
+    activeScheme.table = BUILTIN_TABLE;
+    activeScheme.file = ansi::WHITE;
+    activeScheme.directory = ansi::BLUE_BOLD;
+    activeScheme.symlink = ansi::CYAN;
+    activeScheme.executable = ansi::GREEN_BOLD;
+    activeScheme.hidden = ansi::BLACK_BOLD;
+    activeScheme.storage.clear();
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// Цвет имени файла по расширению. Таблица строится на этапе компиляции
+// (открытая адресация по хэшу FNV-1a), LS_COLORS накладывается на нее
+// один раз при запуске. Поиск не выделяет память.
+class FileColorTable {
+public:
+    // Цвет обычного файла по расширению имени
+    static std::string_view forFileName(std::string_view name);
+    static std::string_view directory();
+    static std::string_view symlink();
+    static std::string_view executable();
+    static std::string_view hidden();
+
+    // Разбирает строку формата LS_COLORS: "di=01;34:ex=01;32:*.tar=01;31"
+    static void loadLsColors(std::string_view spec);
+    // Применяет LS_COLORS из окружения, если переменная задана
+    static void loadFromEnvironment();
+    // Возвращает встроенную схему
+    static void reset();
+
+    // Более длинные расширения не ищутся в таблице
+    static constexpr size_t MAX_EXTENSION_LENGTH = 16;
+};
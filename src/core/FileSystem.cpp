@@ -1,302 +1,205 @@
 #include "FileSystem.h"
 #include "ColorManager.h"
+#include "Profiler.h"
+#include "Formatter.h"
+#include "FileColorTable.h"
+#include "FileSystemProvider.h"
 #include <iostream>
 #include <iomanip>
 #include <locale>
 #include <cmath>
 #include <sstream>
 #include <algorithm>
+#include <sys/stat.h>
 
 namespace fs = std::filesystem;
 
-FileSystem::FileInfo FileSystem::getFileInfo(const fs::path& path) {
-    FileInfo info;
-    info.name = path.filename().string();
-    info.isDirectory = fs::is_directory(path);
-    info.isHidden = isHidden(path);
-    info.isExecutable = isExecutable(path);
-    info.isSymlink = isSymlink(path);
-    
-    try {
-        if (info.isDirectory) {
-            info.size = calculateDirectorySize(path);
-            info.sizeFormatted = formatSize(info.size);
-        } else {
-            info.size = fs::file_size(path);
-            info.sizeFormatted = formatSize(info.size);
-        }
-        
-        info.lastModified = formatTime(fs::last_write_time(path));
-        info.permissions = formatPermissions(fs::status(path).permissions());
-    } catch (const fs::filesystem_error& e) {
-        info.size = 0;
-        info.sizeFormatted = "0 B";
-        info.lastModified = "N/A";
-        info.permissions = "---------";
-    }
-    
-    return info;
+namespace {
+    std::shared_ptr<FileSystemProvider> activeProvider = std::make_shared<PosixFileSystemProvider>();
 }
 
-uint64_t FileSystem::calculateDirectorySize(const fs::path& path) {
-    uint64_t totalSize = 0;
-    
-    try {
-        for (const auto& entry : fs::recursive_directory_iterator(path)) {
-            if (entry.is_regular_file()) {
-                try {
-                    totalSize += entry.file_size();
-                } catch (const fs::filesystem_error&) {
-                    // Пропускаем файлы без доступа
-                }
-            }
-        }
-    } catch (const fs::filesystem_error&) {
-        // Пропускаем директории без доступа
-    }
-    
-    return totalSize;
+void FileSystem::setProvider(std::shared_ptr<FileSystemProvider> provider) {
+    activeProvider = provider ? std::move(provider) : std::make_shared<PosixFileSystemProvider>();
 }
 
-std::string FileSystem::formatSize(uint64_t size) {
-    if (size < constants::KB) {
-        return std::to_string(size) + " B";
-    } else if (size < constants::MB) {
-        return std::to_string(size / constants::KB) + " KB";
-    } else if (size < constants::GB) {
-        return std::to_string(size / constants::MB) + " MB";
-    } else if (size < constants::TB) {
-        return std::to_string(size / constants::GB) + " GB";
-    } else {
-        return std::to_string(size / constants::TB) + " TB";
-    }
+FileSystemProvider& FileSystem::provider() {
+    return *activeProvider;
 }
 
-std::string FileSystem::formatNumber(uint64_t number) {
-    std::string numStr = std::to_string(number);
-    std::string result;
-    
-    int count = 0;
-    for (int i = numStr.length() - 1; i >= 0; i--) {
-        result = numStr[i] + result;
-        count++;
-        if (count % 3 == 0 && i != 0) {
-            result = " " + result;
+bool FileSystem::readDirectory(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) {
+    Profiler::Scope scope(Profiler::Phase::READDIR);
+    return activeProvider->readEntries(path, entries);
+}
+
+bool FileSystem::readMetadata(const fs::path& path, RawMetadata& meta, bool followSymlinks) {
+    Profiler::Scope scope(Profiler::Phase::STAT);
+    return activeProvider->readMetadata(path, meta, followSymlinks);
+}
+
+bool FileSystem::readFile(const fs::path& path, std::string& contents) {
+    return activeProvider->readFile(path, contents);
+}
+
+void FileSystem::readMetadataBatch(const std::vector<const fs::path*>& paths, std::vector<RawMetadata>& metas) {
+    Profiler::Scope scope(Profiler::Phase::STAT);
+    activeProvider->readMetadataBatch(paths, metas);
+}
+
+uint64_t FileSystem::getSyscallCount() {
+    return PosixFileSystemProvider::getSyscallCount();
+}
+
+FileSystem::FileInfo FileSystem::getFileInfo(const fs::path& path) {
+    RawMetadata meta;
+    bool isSymlink = false;
+    resolveMetadata(path, meta, isSymlink);
+    return makeFileInfo(path.filename().string(), meta, isSymlink);
+}
+
+void FileSystem::resolveMetadata(const fs::path& path, RawMetadata& meta, bool& isSymlink) {
+    isSymlink = false;
+    if (!readMetadata(path, meta, false)) {
+        meta = RawMetadata{};
+    } else if (S_ISLNK(meta.mode)) {
+        // Для симлинка показываем свойства цели, как и раньше
+        isSymlink = true;
+        if (!readMetadata(path, meta, true)) {
+            meta = RawMetadata{};
         }
     }
-    
-    return result;
 }
 
-std::string FileSystem::formatSizeWithBytes(uint64_t size) {
-    std::string formattedSize = formatSize(size);
-    std::string formattedBytes = formatNumber(size) + " bytes";
-    return formattedSize + " (" + formattedBytes + ")";
+uint64_t FileSystem::entrySize(const RawMetadata& meta) {
+    return S_ISDIR(meta.mode) ? 0 : meta.size;
 }
 
-std::string FileSystem::formatSizeBothSystems(uint64_t size) {
-    std::stringstream result;
-    
-    // Двоичные приставки
-    std::stringstream ssBinary;
-    ssBinary << std::fixed << std::setprecision(1);
-    
-    if (size < constants::KB) {
-        ssBinary << size << " B";
-    } else if (size < constants::MB) {
-        double kbSize = static_cast<double>(size) / constants::KB;
-        ssBinary << kbSize << " KiB";
-    } else if (size < constants::GB) {
-        double mbSize = static_cast<double>(size) / constants::MB;
-        ssBinary << mbSize << " MiB";
-    } else {
-        double gbSize = static_cast<double>(size) / constants::GB;
-        ssBinary << gbSize << " GiB";
+std::string_view FileSystem::fileName(const fs::path& path) {
+    std::string_view native = path.native();
+    size_t slash = native.rfind('/');
+    return slash == std::string_view::npos ? native : native.substr(slash + 1);
+}
+
+void FileSystem::resolveMetadataBatch(const std::vector<const fs::path*>& paths, std::vector<RawMetadata>& metas,
+                                      std::vector<char>& symlinks) {
+    readMetadataBatch(paths, metas);
+    
+    symlinks.assign(paths.size(), 0);
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!S_ISLNK(metas[i].mode)) {
+            continue;
+        }
+        // Цели симлинков редки и читаются по одной
+        symlinks[i] = 1;
+        if (!readMetadata(*paths[i], metas[i], true)) {
+            metas[i] = RawMetadata{};
+        }
     }
+}
+
+FileSystem::FileInfo FileSystem::makeFileInfo(const std::string& name, const RawMetadata& meta, bool isSymlink) {
+    Profiler::Scope scope(Profiler::Phase::FORMAT);
     
-    std::string binaryResult = ssBinary.str();
-    
-    // Десятичные приставки
-    const uint64_t DECIMAL_KB = 1000;
-    const uint64_t DECIMAL_MB = 1000 * DECIMAL_KB;
-    const uint64_t DECIMAL_GB = 1000 * DECIMAL_MB;
-    
-    std::stringstream ssDecimal;
-    ssDecimal << std::fixed << std::setprecision(1);
-    
-    if (size < DECIMAL_KB) {
-        ssDecimal << size << " B";
-    } else if (size < DECIMAL_MB) {
-        double kbSize = static_cast<double>(size) / DECIMAL_KB;
-        ssDecimal << kbSize << " KB";
-    } else if (size < DECIMAL_GB) {
-        double mbSize = static_cast<double>(size) / DECIMAL_MB;
-        ssDecimal << mbSize << " MB";
-    } else {
-        double gbSize = static_cast<double>(size) / DECIMAL_GB;
-        ssDecimal << gbSize << " GB";
+    FileInfo info;
+    info.name = name;
+    info.meta = meta;
+    info.isDirectory = S_ISDIR(meta.mode);
+    info.isHidden = !name.empty() && name[0] == '.';
+    info.isExecutable = (meta.mode & (S_IXUSR | S_IXGRP | S_IXOTH)) != 0;
+    info.isSymlink = isSymlink;
+    
+    if (meta.mode == 0) {
+        // Метаданные недоступны (нет прав, битая ссылка, файл удален)
+        info.size = 0;
+        info.sizeFormatted = "0 B";
+        info.lastModified = "N/A";
+        info.permissions = "---------";
+        return info;
     }
     
-    std::string decimalResult = ssDecimal.str();
-    std::string formattedBytes = formatNumber(size) + " bytes";
+    // Размер директории не считается здесь: его накапливает обход
+    // дерева по мере выхода из поддерева (см. TreeBuilder::traverseDirectory)
+    info.size = entrySize(meta);
+    char buffer[Formatter::TIME_BUFFER_SIZE];
+    info.sizeFormatted.assign(buffer, Formatter::formatSize(info.size, buffer));
+    info.lastModified.assign(buffer, Formatter::formatTime(meta.mtimeNs / 1000000000LL, buffer));
+    info.permissions.assign(buffer, Formatter::formatPermissions(meta.mode, buffer));
     
-    result << binaryResult << " / " << decimalResult << " (" << formattedBytes << ")";
-    return result.str();
+    return info;
 }
 
-std::string FileSystem::formatTime(const fs::file_time_type& time) {
-    auto sctp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
-        time - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
-    
-    std::time_t tt = std::chrono::system_clock::to_time_t(sctp);
-    std::tm tm = *std::localtime(&tt);
-    
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+std::string FileSystem::formatSize(uint64_t size) {
+    char buffer[Formatter::SIZE_BUFFER_SIZE];
+    return std::string(buffer, Formatter::formatSize(size, buffer));
 }
 
-std::string FileSystem::formatPermissions(const fs::perms& permissions) {
-    std::string result(9, '-');
-    
-    auto setPermission = [&](int pos, fs::perms perm, char ch) {
-        if ((permissions & perm) != fs::perms::none) {
-            result[pos] = ch;
-        }
-    };
-    
-    setPermission(0, fs::perms::owner_read, 'r');
-    setPermission(1, fs::perms::owner_write, 'w');
-    setPermission(2, fs::perms::owner_exec, 'x');
-    setPermission(3, fs::perms::group_read, 'r');
-    setPermission(4, fs::perms::group_write, 'w');
-    setPermission(5, fs::perms::group_exec, 'x');
-    setPermission(6, fs::perms::others_read, 'r');
-    setPermission(7, fs::perms::others_write, 'w');
-    setPermission(8, fs::perms::others_exec, 'x');
-    
-    return result;
+std::string FileSystem::formatNumber(uint64_t number) {
+    char buffer[Formatter::NUMBER_BUFFER_SIZE];
+    return std::string(buffer, Formatter::formatNumber(number, buffer));
 }
 
-bool FileSystem::isHidden(const fs::path& path) {
-    std::string filename = path.filename().string();
-    if (filename.empty()) return false;
-    return filename[0] == '.';
+std::string FileSystem::formatSizeWithBytes(uint64_t size) {
+    return formatSize(size) + " (" + formatNumber(size) + " bytes)";
 }
 
-bool FileSystem::isExecutable(const fs::path& path) {
-    try {
-        auto perms = fs::status(path).permissions();
-        return (perms & (fs::perms::owner_exec | fs::perms::group_exec | fs::perms::others_exec)) != fs::perms::none;
-    } catch (...) {
-    }
-    return false;
+std::string FileSystem::formatSizeBothSystems(uint64_t size) {
+    char buffer[Formatter::SIZE_BOTH_BUFFER_SIZE];
+    return std::string(buffer, Formatter::formatSizeBothSystems(size, buffer));
 }
 
-bool FileSystem::isSymlink(const fs::path& path) {
-    try {
-        return fs::is_symlink(path);
-    } catch (...) {
-    }
-    return false;
+std::string FileSystem::formatTime(std::time_t tt) {
+    char buffer[Formatter::TIME_BUFFER_SIZE];
+    return std::string(buffer, Formatter::formatTime(static_cast<int64_t>(tt), buffer));
+}
+
+std::string FileSystem::formatPermissions(const fs::perms& permissions) {
+    char buffer[Formatter::PERMISSIONS_BUFFER_SIZE];
+    return std::string(buffer, Formatter::formatPermissions(static_cast<uint32_t>(permissions), buffer));
 }
 
-std::string FileSystem::getFileColor(const FileInfo& info) {
+std::string_view FileSystem::getFileColor(const FileInfo& info) {
     if (!ColorManager::areColorsEnabled()) {
-        return "";
+        return {};
     }
     
     if (info.isHidden) {
-        return constants::BLACK + constants::BOLD;
+        return FileColorTable::hidden();
     }
     
     if (info.isDirectory) {
-        return constants::DIR_NAME_COLOR;
+        return FileColorTable::directory();
     }
     
     if (info.isSymlink) {
-        return constants::SYMLINK_COLOR;
+        return FileColorTable::symlink();
     }
     
     if (info.isExecutable) {
-        return constants::EXECUTABLE_COLOR;
-    }
-    
-     std::string extension = info.name.substr(info.name.find_last_of(".") + 1);
-    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
-    
-    // Изображения
-    if (extension == "jpg" || extension == "jpeg" || extension == "png" || 
-        extension == "gif" || extension == "bmp" || extension == "svg" ||
-        extension == "webp" || extension == "tiff") {
-        return constants::IMAGE_COLOR;
-    }
-    
-    // Видео файлы
-    if (extension == "mov" || extension == "mp4" || extension == "avi" || 
-        extension == "mkv" || extension == "wmv" || extension == "flv" ||
-        extension == "webm" || extension == "m4v" || extension == "mpeg") {
-        return constants::MAGENTA + constants::BOLD;  // Яркий пурпурный для видео
+        return FileColorTable::executable();
     }
     
-    // Аудио файлы
-    if (extension == "mp3" || extension == "wav" || extension == "flac" || 
-        extension == "aac" || extension == "ogg" || extension == "wma") {
-        return constants::CYAN + constants::BOLD;  // Яркий голубой для аудио
-    }
-    
-    // Архивы
-    if (extension == "zip" || extension == "rar" || extension == "tar" || 
-        extension == "gz" || extension == "7z" || extension == "bz2" ||
-        extension == "xz" || extension == "lz" || extension == "arj") {
-        return constants::ARCHIVE_COLOR;
-    }
-    
-    // Конфигурационные файлы
-    if (extension == "conf" || extension == "config" || extension == "ini" || 
-        extension == "json" || extension == "xml" || extension == "yaml" || 
-        extension == "yml" || extension == "toml" || extension == "properties") {
-        return constants::CONFIG_COLOR;
-    }
-    
-    // Документы
-    if (extension == "txt" || extension == "doc" || extension == "docx" || 
-        extension == "pdf" || extension == "rtf" || extension == "odt" ||
-        extension == "xls" || extension == "xlsx" || extension == "ppt" || 
-        extension == "pptx" || extension == "epub" || extension == "mobi") {
-        return constants::DOCUMENT_COLOR;
+    return FileColorTable::forFileName(info.name);
+}
+
+std::string_view FileSystem::getFileColor(std::string_view name, const RawMetadata& meta, bool isSymlink) {
+    if (!ColorManager::areColorsEnabled()) {
+        return {};
     }
     
-    // Исходный код
-    if (extension == "cpp" || extension == "h" || extension == "hpp" || 
-        extension == "c" || extension == "java" || extension == "py" || 
-        extension == "js" || extension == "html" || extension == "css" || 
-        extension == "php" || extension == "rb" || extension == "go" ||
-        extension == "rs" || extension == "swift" || extension == "kt" ||
-        extension == "ts" || extension == "scala" || extension == "pl" ||
-        extension == "lua" || extension == "sh" || extension == "bat" ||
-        extension == "ps1" || extension == "md" || extension == "tex") {
-        return constants::CODE_COLOR;
+    if (!name.empty() && name[0] == '.') {
+        return FileColorTable::hidden();
     }
     
-    // Базы данных и данные
-    if (extension == "db" || extension == "sql" || extension == "sqlite" || 
-        extension == "mdb" || extension == "csv" || extension == "tsv" ||
-        extension == "dat" || extension == "log") {
-        return constants::YELLOW;  // Желтый для данных
+    if (S_ISDIR(meta.mode)) {
+        return FileColorTable::directory();
     }
     
-    // Файлы бэкапов
-    if (extension == "bak" || extension == "backup" || extension == "old" ||
-        extension == "tmp" || extension == "temp") {
-        return constants::BLACK;  // Черный для временных файлов
+    if (isSymlink) {
+        return FileColorTable::symlink();
     }
     
-    // Шрифты
-    if (extension == "ttf" || extension == "otf" || extension == "woff" || 
-        extension == "woff2" || extension == "eot") {
-        return constants::MAGENTA;  // Пурпурный для шрифтов
+    if ((meta.mode & (S_IXUSR | S_IXGRP | S_IXOTH)) != 0) {
+        return FileColorTable::executable();
     }
     
-    return constants::WHITE; // Стандартный цвет для остальных файлов
-}
\ No newline at end of file
+    return FileColorTable::forFileName(name);
+}
@@ -1,13 +1,29 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <filesystem>
 #include <chrono>
+#include <ctime>
+#include <memory>
+#include <vector>
 #include "Constants.h"
+#include "DirectoryReader.h"
 
 namespace fs = std::filesystem;
 
+class FileSystemProvider;
+
 class FileSystem {
 public:
+    // Сырые метаданные, полученные одним вызовом statx/lstat
+    struct RawMetadata {
+        uint32_t mode = 0;      // st_mode: тип файла и права
+        uint64_t size = 0;
+        int64_t mtimeNs = 0;    // время изменения, наносекунды от эпохи
+        uint64_t inode = 0;
+        uint64_t nlink = 0;
+    };
+
     struct FileInfo {
         std::string name;
         uint64_t size;
@@ -18,18 +34,40 @@ public:
         bool isExecutable;
         bool isSymlink;
         bool isHidden;
+        RawMetadata meta;
     };
 
     static FileInfo getFileInfo(const fs::path& path);
+    // Метаданные для строки дерева, как в getFileInfo, но без форматирования:
+    // у симлинка - свойства цели, isSymlink - сам путь симлинк
+    static void resolveMetadata(const fs::path& path, RawMetadata& meta, bool& isSymlink);
+    // Размер элемента в выводе: у директорий 0, их размер накапливает обход
+    static uint64_t entrySize(const RawMetadata& meta);
+    // Имя последнего компонента без копирования (строка живет, пока жив path)
+    static std::string_view fileName(const fs::path& path);
+    static FileInfo makeFileInfo(const std::string& name, const RawMetadata& meta, bool isSymlink);
+    // Листинг и метаданные через активного провайдера (см. FileSystemProvider.h)
+    static bool readDirectory(const fs::path& path, std::vector<DirectoryReader::Entry>& entries);
+    static bool readMetadata(const fs::path& path, RawMetadata& meta, bool followSymlinks = false);
+    static bool readFile(const fs::path& path, std::string& contents);
+    // lstat пачки путей одним обращением к провайдеру (io_uring, если доступен)
+    static void readMetadataBatch(const std::vector<const fs::path*>& paths, std::vector<RawMetadata>& metas);
+    // Как readMetadataBatch, но для симлинков - метаданные цели, как в getFileInfo;
+    // symlinks[i] != 0 - paths[i] сам симлинк
+    static void resolveMetadataBatch(const std::vector<const fs::path*>& paths, std::vector<RawMetadata>& metas,
+                                     std::vector<char>& symlinks);
+    // Подменяет источник данных обхода; nullptr возвращает настоящую ФС.
+    // Вызывать только между построениями.
+    static void setProvider(std::shared_ptr<FileSystemProvider> provider);
+    static FileSystemProvider& provider();
+    static uint64_t getSyscallCount();
     static std::string formatSize(uint64_t size);
     static std::string formatSizeWithBytes(uint64_t size);
     static std::string formatSizeBothSystems(uint64_t size);
     static std::string formatNumber(uint64_t number);
-    static std::string formatTime(const fs::file_time_type& time);
+    static std::string formatTime(std::time_t time);
     static std::string formatPermissions(const fs::perms& permissions);
-    static bool isHidden(const fs::path& path);
-    static bool isExecutable(const fs::path& path);
-    static bool isSymlink(const fs::path& path);
-    static uint64_t calculateDirectorySize(const fs::path& path);
-    static std::string getFileColor(const FileInfo& info);
+    // Цвет имени без выделения памяти; пустая строка, если цвета выключены
+    static std::string_view getFileColor(const FileInfo& info);
+    static std::string_view getFileColor(std::string_view name, const RawMetadata& meta, bool isSymlink);
 };
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "FileSystemProvider.h"
+#include "UringStatx.h"
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <memory>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    std::atomic<uint64_t> syscallCount{0};
+
+    std::atomic<unsigned> queueDepth{PosixFileSystemProvider::DEFAULT_QUEUE_DEPTH};
+    // Состояние io_uring выясняется первой пачкой и дальше не меняется
+    enum class UringState { UNKNOWN, ACTIVE, UNAVAILABLE };
+    std::atomic<UringState> uringState{UringState::UNKNOWN};
+    thread_local std::unique_ptr<UringStatx> threadRing;
+
+#ifdef STATX_BASIC_STATS
+    std::atomic<bool> statxUnsupported{false};
+#endif
+}
+
+void FileSystemProvider::readMetadataBatch(const std::vector<const fs::path*>& paths,
+                                           std::vector<FileSystem::RawMetadata>& metas) {
+    metas.assign(paths.size(), FileSystem::RawMetadata{});
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!readMetadata(*paths[i], metas[i], false)) {
+            metas[i] = FileSystem::RawMetadata{};
+        }
+    }
+}
+
+bool FileSystemProvider::readFile(const fs::path&, std::string&) {
+    return false;
+}
+
+bool PosixFileSystemProvider::readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) {
+    return DirectoryReader::readEntries(path, entries);
+}
+
+bool PosixFileSystemProvider::readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool followSymlinks) {
+#ifdef STATX_BASIC_STATS
+    if (!statxUnsupported.load(std::memory_order_relaxed)) {
+        struct statx stx;
+        const int flags = followSymlinks ? 0 : AT_SYMLINK_NOFOLLOW;
+        const unsigned int mask = STATX_TYPE | STATX_MODE | STATX_SIZE |
+                                  STATX_MTIME | STATX_INO | STATX_NLINK;
+
+        syscallCount.fetch_add(1, std::memory_order_relaxed);
+        if (statx(AT_FDCWD, path.c_str(), flags, mask, &stx) == 0) {
+            meta.mode = stx.stx_mode;
+            meta.size = stx.stx_size;
+            meta.mtimeNs = static_cast<int64_t>(stx.stx_mtime.tv_sec) * 1000000000LL + stx.stx_mtime.tv_nsec;
+            meta.inode = stx.stx_ino;
+            meta.nlink = stx.stx_nlink;
+            return true;
+        }
+        if (errno != ENOSYS) {
+            return false;
+        }
+        // Ядро без statx - дальше работаем через lstat/stat
+        statxUnsupported.store(true, std::memory_order_relaxed);
+    }
+#endif
+
+    struct stat st;
+    syscallCount.fetch_add(1, std::memory_order_relaxed);
+    int rc = followSymlinks ? ::stat(path.c_str(), &st) : ::lstat(path.c_str(), &st);
+    if (rc != 0) {
+        return false;
+    }
+
+    meta.mode = st.st_mode;
+    meta.size = static_cast<uint64_t>(st.st_size);
+    meta.mtimeNs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    meta.inode = st.st_ino;
+    meta.nlink = st.st_nlink;
+    return true;
+}
+
+void PosixFileSystemProvider::readMetadataBatch(const std::vector<const fs::path*>& paths,
+                                                std::vector<FileSystem::RawMetadata>& metas) {
+    unsigned depth = queueDepth.load(std::memory_order_relaxed);
+    // Пачка из одного пути быстрее синхронным statx
+    if (paths.size() < 2 || depth == 0 || uringState.load(std::memory_order_relaxed) == UringState::UNAVAILABLE) {
+        FileSystemProvider::readMetadataBatch(paths, metas);
+        return;
+    }
+
+    if (!threadRing || threadRing->getQueueDepth() < depth) {
+        threadRing = std::make_unique<UringStatx>(depth);
+    }
+    uint64_t enterCalls = 0;
+    bool done = threadRing->isOpen() && threadRing->statBatch(paths, metas, enterCalls);
+    syscallCount.fetch_add(enterCalls, std::memory_order_relaxed);
+    if (done) {
+        uringState.store(UringState::ACTIVE, std::memory_order_relaxed);
+        return;
+    }
+
+    // Нет io_uring или операции statx в нем: до конца работы - синхронно
+    uringState.store(UringState::UNAVAILABLE, std::memory_order_relaxed);
+    threadRing.reset();
+    FileSystemProvider::readMetadataBatch(paths, metas);
+}
+
+void PosixFileSystemProvider::setQueueDepth(unsigned depth) {
+    queueDepth.store(depth, std::memory_order_relaxed);
+}
+
+unsigned PosixFileSystemProvider::getQueueDepth() {
+    return queueDepth.load(std::memory_order_relaxed);
+}
+
+bool PosixFileSystemProvider::isBatchingActive() {
+    return uringState.load(std::memory_order_relaxed) == UringState::ACTIVE;
+}
+
+uint64_t PosixFileSystemProvider::getSyscallCount() {
+    return syscallCount.load(std::memory_order_relaxed);
+}
+
+bool PosixFileSystemProvider::readFile(const fs::path& path, std::string& contents) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    contents.clear();
+    char buffer[16 * 1024];
+    while (true) {
+        ssize_t bytes = ::read(fd, buffer, sizeof(buffer));
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            ::close(fd);
+            return bytes == 0;
+        }
+        contents.append(buffer, static_cast<size_t>(bytes));
+    }
+}
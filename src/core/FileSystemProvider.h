@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include "DirectoryReader.h"
+#include "FileSystem.h"
+
+// Источник листингов и метаданных для построителей.
+// Все обращения обхода к файловой системе идут через
+// FileSystem::readDirectory и FileSystem::readMetadata, а те - через
+// активного провайдера (по умолчанию PosixFileSystemProvider).
+class FileSystemProvider {
+public:
+    virtual ~FileSystemProvider() = default;
+
+    // Записи каталога без "." и ".."; false, если каталог не прочитан
+    virtual bool readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) = 0;
+    virtual bool readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool followSymlinks) = 0;
+    // lstat пачки путей, metas[i] - для paths[i]; meta.mode == 0 - путь не прочитан.
+    // По умолчанию - readMetadata для каждого пути по очереди
+    virtual void readMetadataBatch(const std::vector<const fs::path*>& paths,
+                                   std::vector<FileSystem::RawMetadata>& metas);
+    // Содержимое небольшого файла целиком (правила --gitignore); false - не прочитан.
+    // По умолчанию у файлов провайдера содержимого нет
+    virtual bool readFile(const fs::path& path, std::string& contents);
+};
+
+// Настоящая файловая система: getdents64 и statx (lstat без statx).
+// Пачки метаданных уходят в io_uring, если ядро его дает; иначе - тот же
+// синхронный statx по одному пути.
+class PosixFileSystemProvider : public FileSystemProvider {
+public:
+    static constexpr unsigned DEFAULT_QUEUE_DEPTH = 64;
+
+    bool readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) override;
+    bool readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool followSymlinks) override;
+    void readMetadataBatch(const std::vector<const fs::path*>& paths,
+                           std::vector<FileSystem::RawMetadata>& metas) override;
+    bool readFile(const fs::path& path, std::string& contents) override;
+
+    // Глубина очереди io_uring для пачек statx; 0 - только синхронный путь.
+    // Вызывать до обхода: кольца потоков создаются при первой пачке
+    static void setQueueDepth(unsigned depth);
+    static unsigned getQueueDepth();
+    // Пачки действительно идут через io_uring (проверено на ядре)
+    static bool isBatchingActive();
+
+    // Число вызовов statx/lstat/stat и io_uring_enter за время работы
+    static uint64_t getSyscallCount();
+};
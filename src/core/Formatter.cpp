@@ -0,0 +1,204 @@
+#include "Formatter.h"
+#include "Constants.h"
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <ctime>
+
+namespace {
+    constexpr int64_t SECONDS_PER_DAY = 86400;
+    // Около трех лет разных суток без вытеснения, 16 КиБ на поток
+    constexpr size_t OFFSET_CACHE_SIZE = 1024;
+
+    // Смещение пояса для суток UTC; uniform = смещение не менялось
+    // в течение этих суток (нет перехода на летнее время)
+    struct OffsetEntry {
+        int64_t utcDay = INT64_MIN;
+        int32_t offset = 0;
+        bool uniform = false;
+    };
+
+    struct DateEntry {
+        int64_t localDay = INT64_MIN;
+        char text[10];
+    };
+
+    // Кэши на поток: рабочие потоки не делят строки кэша и блокировки
+    thread_local OffsetEntry offsetCache[OFFSET_CACHE_SIZE];
+    thread_local DateEntry dateCache;
+
+    int64_t floorDiv(int64_t value, int64_t divisor) {
+        int64_t quotient = value / divisor;
+        if (value % divisor != 0 && value < 0) {
+            --quotient;
+        }
+        return quotient;
+    }
+
+    const OffsetEntry& offsetForDay(int64_t utcDay) {
+        auto& entry = offsetCache[static_cast<uint64_t>(utcDay) % OFFSET_CACHE_SIZE];
+        if (entry.utcDay != utcDay) {
+            std::time_t first = static_cast<std::time_t>(utcDay * SECONDS_PER_DAY);
+            std::time_t last = first + SECONDS_PER_DAY - 1;
+            std::tm firstTm = {};
+            std::tm lastTm = {};
+            bool ok = localtime_r(&first, &firstTm) && localtime_r(&last, &lastTm);
+
+            entry.utcDay = utcDay;
+            entry.offset = static_cast<int32_t>(firstTm.tm_gmtoff);
+            entry.uniform = ok && firstTm.tm_gmtoff == lastTm.tm_gmtoff;
+        }
+        return entry;
+    }
+
+    // Дни от эпохи в григорианскую дату (алгоритм civil_from_days Г. Хиннанта)
+    void civilFromDays(int64_t days, int64_t& year, unsigned& month, unsigned& day) {
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+        const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+        const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+        const unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+
+        day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+        month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+        year = static_cast<int64_t>(yearOfEra) + era * 400 + (month <= 2 ? 1 : 0);
+    }
+
+    char* writeTwoDigits(char* out, unsigned value) {
+        out[0] = static_cast<char>('0' + value / 10);
+        out[1] = static_cast<char>('0' + value % 10);
+        return out + 2;
+    }
+
+    // Редкие случаи (переход на летнее время, годы вне 1000..9999)
+    size_t formatTimeSlow(int64_t epochSeconds, char* buffer) {
+        std::time_t tt = static_cast<std::time_t>(epochSeconds);
+        std::tm tm = {};
+        localtime_r(&tt, &tm);
+        return std::strftime(buffer, Formatter::TIME_BUFFER_SIZE, "%Y-%m-%d %H:%M:%S", &tm);
+    }
+
+    size_t appendLiteral(char* out, const char* text) {
+        size_t length = std::strlen(text);
+        std::memcpy(out, text, length);
+        return length;
+    }
+
+    // Значение с одним знаком после запятой и единицей: "240.3 MiB"
+    size_t formatScaled(uint64_t size, uint64_t kilo, const char* const units[4], char* buffer) {
+        char* out = buffer;
+        if (size < kilo) {
+            out = std::to_chars(out, buffer + Formatter::SIZE_BUFFER_SIZE, size).ptr;
+            out += appendLiteral(out, units[0]);
+            return static_cast<size_t>(out - buffer);
+        }
+
+        uint64_t unit = kilo;
+        size_t index = 1;
+        while (index < 3 && size >= unit * kilo) {
+            unit *= kilo;
+            ++index;
+        }
+
+        double value = static_cast<double>(size) / unit;
+        out = std::to_chars(out, buffer + Formatter::SIZE_BUFFER_SIZE, value,
+                            std::chars_format::fixed, 1).ptr;
+        out += appendLiteral(out, units[index]);
+        return static_cast<size_t>(out - buffer);
+    }
+}
+
+size_t Formatter::formatSize(uint64_t size, char* buffer) {
+    static const uint64_t units[] = {1, constants::KB, constants::MB, constants::GB, constants::TB};
+    static const char* const suffixes[] = {" B", " KB", " MB", " GB", " TB"};
+
+    size_t index = 0;
+    while (index < 4 && size >= units[index + 1]) {
+        ++index;
+    }
+
+    char* out = std::to_chars(buffer, buffer + SIZE_BUFFER_SIZE, size / units[index]).ptr;
+    out += appendLiteral(out, suffixes[index]);
+    return static_cast<size_t>(out - buffer);
+}
+
+size_t Formatter::formatNumber(uint64_t number, char* buffer) {
+    char digits[20]{};
+    size_t count = static_cast<size_t>(std::to_chars(digits, digits + sizeof(digits), number).ptr - digits);
+
+    // Первая группа может быть короче трех цифр, дальше - по три через пробел
+    size_t head = count % 3 == 0 ? 3 : count % 3;
+    char* out = buffer;
+    std::memcpy(out, digits, head);
+    out += head;
+    for (size_t i = head; i < count; i += 3) {
+        *out++ = ' ';
+        std::memcpy(out, digits + i, 3);
+        out += 3;
+    }
+    return static_cast<size_t>(out - buffer);
+}
+
+size_t Formatter::formatSizeBothSystems(uint64_t size, char* buffer) {
+    static const char* const binaryUnits[] = {" B", " KiB", " MiB", " GiB"};
+    static const char* const decimalUnits[] = {" B", " KB", " MB", " GB"};
+
+    char* out = buffer;
+    out += formatScaled(size, constants::KB, binaryUnits, out);
+    out += appendLiteral(out, " / ");
+    out += formatScaled(size, 1000, decimalUnits, out);
+    out += appendLiteral(out, " (");
+    out += formatNumber(size, out);
+    out += appendLiteral(out, " bytes)");
+    return static_cast<size_t>(out - buffer);
+}
+
+size_t Formatter::formatTime(int64_t epochSeconds, char* buffer) {
+    const OffsetEntry& zone = offsetForDay(floorDiv(epochSeconds, SECONDS_PER_DAY));
+    if (!zone.uniform) {
+        return formatTimeSlow(epochSeconds, buffer);
+    }
+
+    int64_t local = epochSeconds + zone.offset;
+    int64_t localDay = floorDiv(local, SECONDS_PER_DAY);
+    unsigned secondOfDay = static_cast<unsigned>(local - localDay * SECONDS_PER_DAY);
+
+    if (dateCache.localDay != localDay) {
+        int64_t year;
+        unsigned month;
+        unsigned day;
+        civilFromDays(localDay, year, month, day);
+        if (year < 1000 || year > 9999) {
+            return formatTimeSlow(epochSeconds, buffer);
+        }
+
+        char* out = dateCache.text;
+        out = writeTwoDigits(out, static_cast<unsigned>(year / 100));
+        out = writeTwoDigits(out, static_cast<unsigned>(year % 100));
+        *out++ = '-';
+        out = writeTwoDigits(out, month);
+        *out++ = '-';
+        writeTwoDigits(out, day);
+        dateCache.localDay = localDay;
+    }
+
+    char* out = buffer;
+    std::memcpy(out, dateCache.text, sizeof(dateCache.text));
+    out += sizeof(dateCache.text);
+    *out++ = ' ';
+    out = writeTwoDigits(out, secondOfDay / 3600);
+    *out++ = ':';
+    out = writeTwoDigits(out, secondOfDay / 60 % 60);
+    *out++ = ':';
+    out = writeTwoDigits(out, secondOfDay % 60);
+    return static_cast<size_t>(out - buffer);
+}
+
+size_t Formatter::formatPermissions(uint32_t mode, char* buffer) {
+    static const char symbols[] = "rwxrwxrwx";
+    for (size_t i = 0; i < PERMISSIONS_BUFFER_SIZE; ++i) {
+        buffer[i] = (mode & (0400u >> i)) ? symbols[i] : '-';
+    }
+    return PERMISSIONS_BUFFER_SIZE;
+}
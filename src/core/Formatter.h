@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Форматирование без выделения памяти: результат пишется в буфер
+// вызывающего, функции возвращают число записанных символов.
+// Строковые варианты в FileSystem построены поверх этих функций.
+class Formatter {
+public:
+    static constexpr size_t NUMBER_BUFFER_SIZE = 32;       // 20 цифр и 6 разделителей
+    static constexpr size_t SIZE_BUFFER_SIZE = 32;         // "18446744073709551615 B"
+    static constexpr size_t SIZE_BOTH_BUFFER_SIZE = 96;    // "1.0 KiB / 1.0 KB (1 024 bytes)"
+    static constexpr size_t TIME_BUFFER_SIZE = 32;         // "YYYY-MM-DD HH:MM:SS"
+    static constexpr size_t PERMISSIONS_BUFFER_SIZE = 9;   // "rwxr-xr-x"
+
+    // Целое число единиц: "512 B", "3 KB", "10 MB"
+    static size_t formatSize(uint64_t size, char* buffer);
+    // Разряды через пробел: "1 234 567"
+    static size_t formatNumber(uint64_t number, char* buffer);
+    // "240.3 MiB / 252.0 MB (252 004 745 bytes)"
+    static size_t formatSizeBothSystems(uint64_t size, char* buffer);
+    // Локальное время "YYYY-MM-DD HH:MM:SS". Смещение часового пояса
+    // кэшируется на сутки, дата - на последний встреченный день,
+    // поэтому localtime_r вызывается только при смене суток.
+    static size_t formatTime(int64_t epochSeconds, char* buffer);
+    // Права в виде "rwxr-xr-x" по младшим 9 битам st_mode
+    static size_t formatPermissions(uint32_t mode, char* buffer);
+};
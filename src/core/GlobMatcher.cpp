@@ -0,0 +1,221 @@
+#include "GlobMatcher.h"
+#include <algorithm>
+
+namespace {
+    inline unsigned char fold(unsigned char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+    }
+
+    // folded уже в нижнем регистре
+    bool equalsFolded(std::string_view text, std::string_view folded) {
+        for (size_t i = 0; i < folded.size(); ++i) {
+            if (fold(static_cast<unsigned char>(text[i])) != static_cast<unsigned char>(folded[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string foldString(std::string_view text) {
+        std::string result(text);
+        for (auto& c : result) {
+            c = static_cast<char>(fold(static_cast<unsigned char>(c)));
+        }
+        return result;
+    }
+
+    // Подряд идущие * равносильны одной
+    std::string collapseStars(const std::string& pattern) {
+        std::string result;
+        for (char c : pattern) {
+            if (c != '*' || result.empty() || result.back() != '*') {
+                result += c;
+            }
+        }
+        return result;
+    }
+}
+
+void GlobMatcher::LiteralIndex::add(Literal literal) {
+    literals.push_back(std::move(literal));
+    std::stable_sort(literals.begin(), literals.end(),
+                     [](const Literal& a, const Literal& b) { return a.key < b.key; });
+    size_t position = 0;
+    for (size_t key = 0; key <= 256; ++key) {
+        while (position < literals.size() && literals[position].key < key) {
+            ++position;
+        }
+        index[key] = static_cast<uint16_t>(position);
+    }
+}
+
+uint8_t GlobMatcher::LiteralIndex::match(std::string_view name, unsigned char key, bool suffix) const {
+    uint8_t found = 0;
+    for (size_t i = index[key]; i < index[key + 1]; ++i) {
+        const auto& literal = literals[i];
+        size_t length = literal.text.size();
+        if (literal.exact ? name.size() != length : name.size() < length) {
+            continue;
+        }
+        std::string_view part = suffix ? name.substr(name.size() - length) : name.substr(0, length);
+        if (equalsFolded(part, literal.text)) {
+            found |= literal.include ? INCLUDED : EXCLUDED;
+        }
+    }
+    return found;
+}
+
+void GlobMatcher::add(const std::string& rawPattern, bool include) {
+    (include ? includeCount_ : excludeCount_)++;
+    std::string pattern = collapseStars(rawPattern);
+
+    size_t stars = std::count(pattern.begin(), pattern.end(), '*');
+    bool anyChar = pattern.find('?') != std::string::npos;
+    if (!anyChar && pattern.size() > stars) {
+        if (stars == 0) {
+            std::string text = foldString(pattern);
+            unsigned char key = static_cast<unsigned char>(text.back());
+            suffixes_.add(Literal{key, std::move(text), true, include});
+            return;
+        }
+        if (stars == 1 && pattern.front() == '*') {
+            std::string text = foldString(std::string_view(pattern).substr(1));
+            unsigned char key = static_cast<unsigned char>(text.back());
+            suffixes_.add(Literal{key, std::move(text), false, include});
+            return;
+        }
+        if (stars == 1 && pattern.back() == '*') {
+            std::string text = foldString(std::string_view(pattern).substr(0, pattern.size() - 1));
+            unsigned char key = static_cast<unsigned char>(text.front());
+            prefixes_.add(Literal{key, std::move(text), false, include});
+            return;
+        }
+    }
+    addToAutomaton(pattern, include);
+}
+
+void GlobMatcher::addToAutomaton(const std::string& pattern, bool include) {
+    (include ? automataInclude_ : automataExclude_) = true;
+
+    size_t positions = 0;
+    for (char c : pattern) {
+        positions += c != '*';
+    }
+    if (positions + 1 > 64) {
+        longPatterns_.emplace_back(pattern, include);
+        return;
+    }
+
+    auto word = std::find_if(automata_.begin(), automata_.end(), [positions](const Automaton& automaton) {
+        return automaton.used + positions + 1 <= 64;
+    });
+    if (word == automata_.end()) {
+        automata_.emplace_back();
+        word = automata_.end() - 1;
+    }
+
+    // Бит bit - совпала часть шаблона до текущей позиции; * дает петлю
+    // на предыдущем состоянии, так что оно сохраняется при любом байте
+    unsigned bit = word->used;
+    word->start |= uint64_t{1} << bit;
+    for (char c : pattern) {
+        if (c == '*') {
+            word->loop |= uint64_t{1} << bit;
+            continue;
+        }
+        ++bit;
+        uint64_t mask = uint64_t{1} << bit;
+        if (c == '?') {
+            for (auto& accepts : word->accepts) {
+                accepts |= mask;
+            }
+        } else {
+            unsigned char lower = fold(static_cast<unsigned char>(c));
+            word->accepts[lower] |= mask;
+            if (lower >= 'a' && lower <= 'z') {
+                word->accepts[lower - ('a' - 'A')] |= mask;
+            }
+        }
+    }
+    (include ? word->includeFinal : word->excludeFinal) |= uint64_t{1} << bit;
+    word->used = bit + 1;
+}
+
+void GlobMatcher::clear() {
+    *this = GlobMatcher();
+}
+
+bool GlobMatcher::matches(std::string_view name) const {
+    if (empty()) {
+        return true;
+    }
+    uint8_t found = 0;
+    if (!name.empty()) {
+        found = suffixes_.match(name, fold(static_cast<unsigned char>(name.back())), true) |
+                prefixes_.match(name, fold(static_cast<unsigned char>(name.front())), false);
+    }
+    if (found & EXCLUDED) {
+        return false;
+    }
+    // Автомат нужен, пока не найдено включение или среди его шаблонов есть исключения
+    if (automataExclude_ || (automataInclude_ && !(found & INCLUDED))) {
+        found |= matchAutomata(name);
+        if (found & EXCLUDED) {
+            return false;
+        }
+    }
+    return includeCount_ == 0 || (found & INCLUDED);
+}
+
+uint8_t GlobMatcher::matchAutomata(std::string_view name) const {
+    uint8_t found = 0;
+    for (const auto& automaton : automata_) {
+        uint64_t state = automaton.start;
+        for (char c : name) {
+            state = ((state << 1) & automaton.accepts[static_cast<unsigned char>(c)]) | (state & automaton.loop);
+            if (state == 0) {
+                break;
+            }
+        }
+        if (state & automaton.includeFinal) {
+            found |= INCLUDED;
+        }
+        if (state & automaton.excludeFinal) {
+            found |= EXCLUDED;
+        }
+    }
+    for (const auto& [pattern, include] : longPatterns_) {
+        if (matchGlob(pattern, name)) {
+            found |= include ? INCLUDED : EXCLUDED;
+        }
+    }
+    return found;
+}
+
+bool GlobMatcher::matchGlob(std::string_view pattern, std::string_view name) {
+    size_t p = 0;
+    size_t n = 0;
+    size_t starPattern = std::string_view::npos;
+    size_t starName = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && pattern[p] == '*') {
+            starPattern = p++;
+            starName = n;
+        } else if (p < pattern.size() &&
+                   (pattern[p] == '?' ||
+                    fold(static_cast<unsigned char>(pattern[p])) == fold(static_cast<unsigned char>(name[n])))) {
+            ++p;
+            ++n;
+        } else if (starPattern != std::string_view::npos) {
+            // Последняя * забирает еще один байт
+            p = starPattern + 1;
+            n = ++starName;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') {
+        ++p;
+    }
+    return p == pattern.size();
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Набор шаблонов имен с * и ? (без учета регистра ASCII), компилируемый один раз.
+// Имя проходит, если подходит под любой шаблон включения (или их нет)
+// и ни под один шаблон исключения.
+// Шаблоны вида "имя", "*.cpp" и "test*" проверяются сравнением хвоста или
+// начала имени, списки разбиты по последнему/первому байту. Остальные шаблоны
+// сливаются в один недетерминированный автомат (Shift-And по 64-битным словам):
+// имя проходится один раз для всех шаблонов сразу, без выделения памяти.
+class GlobMatcher {
+public:
+    void add(const std::string& pattern, bool include);
+    void clear();
+
+    bool empty() const { return includeCount_ == 0 && excludeCount_ == 0; }
+    bool matches(std::string_view name) const;
+
+    // Сопоставление одного шаблона без компиляции (перебор с возвратом к последней *)
+    static bool matchGlob(std::string_view pattern, std::string_view name);
+
+private:
+    enum Found : uint8_t { INCLUDED = 1, EXCLUDED = 2 };
+
+    // Шаблон без ? и * внутри: сравнивается с концом (началом) имени
+    struct Literal {
+        unsigned char key;  // последний (первый) байт, в нижнем регистре
+        std::string text;   // в нижнем регистре
+        bool exact;         // без * - имя целиком
+        bool include;
+    };
+
+    // Шаблоны отсортированы по ключу: index[b]..index[b + 1] - шаблоны с ключом b
+    struct LiteralIndex {
+        std::vector<Literal> literals;
+        std::array<uint16_t, 257> index{};
+
+        void add(Literal literal);
+        uint8_t match(std::string_view name, unsigned char key, bool suffix) const;
+    };
+
+    // Слово автомата: на каждый шаблон начальный бит и по биту на позицию
+    struct Automaton {
+        std::array<uint64_t, 256> accepts{};  // позиции, принимающие байт
+        uint64_t start = 0;
+        uint64_t loop = 0;                    // состояния с петлей по *
+        uint64_t includeFinal = 0;
+        uint64_t excludeFinal = 0;
+        unsigned used = 0;
+    };
+
+    LiteralIndex suffixes_;  // "*.cpp" и имена целиком - по последнему байту
+    LiteralIndex prefixes_;  // "test*" - по первому байту
+    std::vector<Automaton> automata_;
+    // Шаблоны длиннее 63 позиций сопоставляются перебором
+    std::vector<std::pair<std::string, bool>> longPatterns_;
+    size_t includeCount_ = 0;
+    size_t excludeCount_ = 0;
+    bool automataInclude_ = false;
+    bool automataExclude_ = false;
+
+    void addToAutomaton(const std::string& pattern, bool include);
+    uint8_t matchAutomata(std::string_view name) const;
+};
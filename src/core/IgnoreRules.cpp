@@ -0,0 +1,326 @@
+#include "IgnoreRules.h"
+#include "FileSystem.h"
+#include <algorithm>
+#include <fnmatch.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+    bool hasWildcards(std::string_view text) {
+        return text.find_first_of("*?[\\") != std::string_view::npos;
+    }
+
+    // Ключ области: путь без завершающих разделителей, чтобы совпадать с префиксами путей детей
+    std::string keyOf(const fs::path& dir) {
+        std::string key = dir.native();
+        while (key.size() > 1 && key.back() == '/') {
+            key.pop_back();
+        }
+        return key;
+    }
+
+    bool isIgnoreFile(const std::string& name) {
+        return name == ".gitignore" || name == ".ignore";
+    }
+
+    bool matchSegment(const std::string& pattern, std::string_view text) {
+        if (!hasWildcards(pattern)) {
+            return pattern == text;
+        }
+        return fnmatch(pattern.c_str(), std::string(text).c_str(), 0) == 0;
+    }
+
+    bool matchParts(const std::vector<std::string>& pattern, size_t p,
+                    const std::vector<std::string_view>& parts, size_t i) {
+        if (p == pattern.size()) {
+            return i == parts.size();
+        }
+        if (pattern[p] == "**") {
+            // "dir/**" - только содержимое dir, но не сама dir
+            if (p + 1 == pattern.size()) {
+                return i < parts.size();
+            }
+            for (size_t k = i; k <= parts.size(); ++k) {
+                if (matchParts(pattern, p + 1, parts, k)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        if (i == parts.size() || !matchSegment(pattern[p], parts[i])) {
+            return false;
+        }
+        return matchParts(pattern, p + 1, parts, i + 1);
+    }
+}
+
+IgnoreRules::IgnoreRules(const fs::path& root) : buckets_(new std::atomic<const Node*>[BUCKET_COUNT]) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    std::error_code ec;
+    fs::path absolute = fs::absolute(root, ec).lexically_normal();
+    if (ec) {
+        return;
+    }
+    if (absolute.filename().empty() && absolute.has_parent_path()) {
+        absolute = absolute.parent_path();
+    }
+
+    // Корень репозитория - ближайший предок (или сам корень) с .git
+    std::vector<fs::path> chain;
+    fs::path repository;
+    for (fs::path current = absolute; ; current = current.parent_path()) {
+        chain.push_back(current);
+        FileSystem::RawMetadata meta;
+        if (FileSystem::readMetadata(current / ".git", meta)) {
+            repository = current;
+            break;
+        }
+        if (current == current.parent_path()) {
+            return;
+        }
+    }
+
+    // Правила предков проверяются после правил внутри корня, самые верхние - последними
+    std::string base = keyOf(root);
+    auto addScope = [&](const fs::path& directory, std::vector<Rule> rules) {
+        if (rules.empty()) {
+            return;
+        }
+        auto scope = std::make_shared<Scope>();
+        scope->parent = ancestors_;
+        scope->base = base;
+        std::string prefix = absolute.lexically_relative(directory).generic_string();
+        if (prefix != ".") {
+            scope->prefix = prefix + "/";
+        }
+        scope->rules = std::move(rules);
+        ancestors_ = std::move(scope);
+    };
+
+    std::vector<Rule> exclude;
+    readRules(repository / ".git" / "info" / "exclude", exclude);
+    addScope(repository, std::move(exclude));
+    for (size_t i = chain.size(); i-- > 1;) {
+        std::vector<Rule> rules;
+        readRules(chain[i] / ".gitignore", rules);
+        readRules(chain[i] / ".ignore", rules);
+        addScope(chain[i], std::move(rules));
+    }
+}
+
+std::vector<IgnoreRules::Rule> IgnoreRules::parse(std::string_view text) {
+    std::vector<Rule> rules;
+    size_t position = 0;
+    while (position < text.size()) {
+        size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string line(text.substr(position, end - position));
+        position = end + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        // Завершающие пробелы отбрасываются, если не экранированы
+        while (!line.empty() && line.back() == ' ' &&
+               !(line.size() > 1 && line[line.size() - 2] == '\\')) {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        Rule rule;
+        if (line[0] == '!') {
+            rule.negated = true;
+            line.erase(0, 1);
+        } else if (line[0] == '\\' && line.size() > 1 && (line[1] == '!' || line[1] == '#')) {
+            line.erase(0, 1);
+        }
+        if (!line.empty() && line.back() == '/') {
+            rule.directoryOnly = true;
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        // Шаблон со / в начале или середине привязан к каталогу файла
+        rule.anchored = line.find('/') != std::string::npos;
+        size_t start = 0;
+        while (start <= line.size()) {
+            size_t slash = line.find('/', start);
+            if (slash == std::string::npos) {
+                slash = line.size();
+            }
+            std::string segment = line.substr(start, slash - start);
+            bool repeatedStars = segment == "**" && !rule.segments.empty() && rule.segments.back() == "**";
+            if (!segment.empty() && !repeatedStars) {
+                rule.segments.push_back(std::move(segment));
+            }
+            start = slash + 1;
+        }
+        if (rule.segments.empty()) {
+            continue;
+        }
+
+        if (!rule.anchored) {
+            std::string& pattern = rule.segments.front();
+            if (!hasWildcards(pattern)) {
+                rule.kind = Rule::Kind::LITERAL;
+            } else if (pattern.size() > 1 && pattern[0] == '*' && !hasWildcards(std::string_view(pattern).substr(1))) {
+                rule.kind = Rule::Kind::SUFFIX;
+                pattern.erase(0, 1);
+            }
+        }
+        rules.push_back(std::move(rule));
+    }
+    return rules;
+}
+
+IgnoreRules::~IgnoreRules() {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        const Node* node = buckets_[i].load(std::memory_order_relaxed);
+        while (node) {
+            const Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+}
+
+bool IgnoreRules::readRules(const fs::path& file, std::vector<Rule>& rules) {
+    std::string contents;
+    if (!FileSystem::readFile(file, contents)) {
+        return false;
+    }
+    auto parsed = parse(contents);
+    rules.insert(rules.end(), std::make_move_iterator(parsed.begin()), std::make_move_iterator(parsed.end()));
+    return true;
+}
+
+const IgnoreRules::Node* IgnoreRules::find(std::string_view key) const {
+    const auto& bucket = buckets_[std::hash<std::string_view>{}(key) % BUCKET_COUNT];
+    for (const Node* node = bucket.load(std::memory_order_acquire); node; node = node->next) {
+        if (node->key == key) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+void IgnoreRules::publish(std::string key, std::shared_ptr<const Scope> scope) {
+    auto& bucket = buckets_[std::hash<std::string_view>{}(key) % BUCKET_COUNT];
+    auto* node = new Node{std::move(key), std::move(scope), bucket.load(std::memory_order_relaxed)};
+    while (!bucket.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
+
+const IgnoreRules::Scope* IgnoreRules::inherited(std::string_view key) const {
+    // Ближайший предок со своими правилами; разбор пути - по строке ключа
+    while (key.size() > 1) {
+        size_t slash = key.rfind('/');
+        if (slash == std::string_view::npos) {
+            break;
+        }
+        key = key.substr(0, slash == 0 ? 1 : slash);
+        if (const Node* node = find(key); node && node->scope) {
+            return node->scope.get();
+        }
+    }
+    return ancestors_.get();
+}
+
+const IgnoreRules::Scope* IgnoreRules::scopeFor(const fs::path& dir,
+                                                const std::vector<DirectoryReader::Entry>& entries) {
+    bool hasRules = std::any_of(entries.begin(), entries.end(), [](const DirectoryReader::Entry& entry) {
+        return isIgnoreFile(entry.name) && entry.type != DirectoryReader::EntryType::DIRECTORY;
+    });
+    std::string key = keyOf(dir);
+
+    if (!hasRules) {
+        // Файл правил мог исчезнуть с прошлого чтения (--watch)
+        if (const Node* node = find(key); node && node->scope) {
+            publish(key, nullptr);
+        }
+        return inherited(key);
+    }
+
+    std::vector<Rule> rules;
+    readRules(dir / ".gitignore", rules);
+    readRules(dir / ".ignore", rules);
+
+    auto scope = std::make_shared<Scope>();
+    scope->base = key;
+    scope->rules = std::move(rules);
+    if (const Scope* parent = inherited(key)) {
+        scope->parent = parent->shared_from_this();
+    }
+    const Scope* result = scope.get();
+    publish(std::move(key), std::move(scope));
+    return result;
+}
+
+bool IgnoreRules::matches(const Rule& rule, std::string_view relative, std::string_view name) {
+    if (!rule.anchored) {
+        const std::string& pattern = rule.segments.front();
+        switch (rule.kind) {
+            case Rule::Kind::LITERAL:
+                return name == pattern;
+            case Rule::Kind::SUFFIX:
+                return name.size() >= pattern.size() &&
+                       name.compare(name.size() - pattern.size(), pattern.size(), pattern) == 0;
+            case Rule::Kind::GLOB:
+                return matchSegment(pattern, name);
+        }
+    }
+
+    std::vector<std::string_view> parts;
+    size_t start = 0;
+    while (start < relative.size()) {
+        size_t slash = relative.find('/', start);
+        if (slash == std::string_view::npos) {
+            slash = relative.size();
+        }
+        parts.push_back(relative.substr(start, slash - start));
+        start = slash + 1;
+    }
+    return matchParts(rule.segments, 0, parts, 0);
+}
+
+bool IgnoreRules::isIgnored(const Scope& scope, const fs::path& path,
+                            std::string_view name, bool isDirectory) {
+    // Метаданные git не показываются никогда
+    if (name == ".git") {
+        return true;
+    }
+
+    const std::string& full = path.native();
+    for (const Scope* current = &scope; current; current = current->parent.get()) {
+        // Путь относительно каталога правил нужен только привязанным шаблонам
+        std::string relative;
+        bool relativeReady = false;
+        for (auto rule = current->rules.rbegin(); rule != current->rules.rend(); ++rule) {
+            if (rule->directoryOnly && !isDirectory) {
+                continue;
+            }
+            if (rule->anchored && !relativeReady) {
+                const std::string& base = current->base;
+                size_t offset = base.size() + (base.empty() || base.back() == '/' ? 0 : 1);
+                if (full.size() <= offset || full.compare(0, base.size(), base) != 0) {
+                    continue;
+                }
+                relative = current->prefix + full.substr(offset);
+                relativeReady = true;
+            }
+            if (matches(*rule, relative, name)) {
+                return !rule->negated;
+            }
+        }
+    }
+    return false;
+}
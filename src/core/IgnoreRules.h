@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DirectoryReader.h"
+
+// Правила .gitignore и .ignore (--gitignore).
+// Файлы правил читаются по мере обхода: правила каталога компилируются один
+// раз при его чтении и вместе с унаследованными от родителя образуют Scope.
+// Проверка идет от самого глубокого файла к корню, внутри файла - с конца;
+// решает первое совпадение. Игнорируемая директория не открывается, так что
+// вложенные в нее правила не нужны (как и в git, вернуть ее содержимое
+// отрицанием нельзя). Правила предков корня обхода читаются до корня репозитория,
+// туда же добавляется .git/info/exclude. Файлы читаются через активного
+// провайдера FileSystem, поиск области каталога обходится без блокировок.
+class IgnoreRules {
+public:
+    struct Rule {
+        enum class Kind { LITERAL, SUFFIX, GLOB };
+        // Без / в середине шаблон сравнивается с именем на любой глубине,
+        // иначе - с путем относительно каталога файла, по сегментам ("**" - любое число)
+        std::vector<std::string> segments;
+        Kind kind = Kind::GLOB;  // для одного сегмента: сравнение, хвост "*.ext" или fnmatch
+        bool anchored = false;
+        bool negated = false;
+        bool directoryOnly = false;
+    };
+
+    struct Scope : std::enable_shared_from_this<Scope> {
+        std::shared_ptr<const Scope> parent;
+        // Путь каталога правил в виде, в котором его строит обход;
+        // для предков корня - корень и путь корня относительно предка в prefix
+        std::string base;
+        std::string prefix;
+        std::vector<Rule> rules;
+    };
+
+    explicit IgnoreRules(const std::filesystem::path& root);
+    ~IgnoreRules();
+    IgnoreRules(const IgnoreRules&) = delete;
+    IgnoreRules& operator=(const IgnoreRules&) = delete;
+
+    // Правила для элементов каталога dir по его листингу; область живет,
+    // пока жив IgnoreRules (узлы не освобождаются до конца работы)
+    const Scope* scopeFor(const std::filesystem::path& dir,
+                          const std::vector<DirectoryReader::Entry>& entries);
+    static bool isIgnored(const Scope& scope, const std::filesystem::path& path,
+                          std::string_view name, bool isDirectory);
+
+    // Разбор одного файла правил; пустые строки и комментарии пропускаются
+    static std::vector<Rule> parse(std::string_view text);
+
+private:
+    // Своя область каталога с файлами правил. Узлы только добавляются в начало
+    // списка корзины и живут до конца работы, поэтому читатели идут по списку
+    // без блокировок; более новый узел того же каталога (--watch) стоит раньше,
+    // scope == nullptr - файлы правил из каталога удалены
+    struct Node {
+        std::string key;
+        std::shared_ptr<const Scope> scope;
+        const Node* next = nullptr;
+    };
+    static constexpr size_t BUCKET_COUNT = 4096;
+
+    std::shared_ptr<const Scope> ancestors_;
+    std::unique_ptr<std::atomic<const Node*>[]> buckets_;
+
+    const Node* find(std::string_view key) const;
+    void publish(std::string key, std::shared_ptr<const Scope> scope);
+    const Scope* inherited(std::string_view key) const;
+    static bool readRules(const std::filesystem::path& file, std::vector<Rule>& rules);
+    static bool matches(const Rule& rule, std::string_view relative, std::string_view name);
+};
@@ -0,0 +1,108 @@
+#include "LineRenderer.h"
+#include "ColorManager.h"
+#include "Constants.h"
+#include "Formatter.h"
+#include "Profiler.h"
+#include <sys/stat.h>
+
+void LineRenderer::pushLevel(bool isLast) {
+    levels_.push_back(prefix_.size());
+    prefix_ += isLast ? constants::TREE_SPACE : constants::TREE_VERTICAL;
+}
+
+void LineRenderer::popLevel() {
+    prefix_.resize(levels_.back());
+    levels_.pop_back();
+}
+
+void LineRenderer::clear() {
+    prefix_.clear();
+    levels_.clear();
+    line_.clear();
+}
+
+void LineRenderer::beginLine(bool isLast) {
+    line_.assign(prefix_);
+    line_ += isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
+}
+
+void LineRenderer::appendEntry(const FileSystem::FileInfo& info) {
+    appendEntry(line_, info);
+}
+
+void LineRenderer::appendEntry(std::string& out, const FileSystem::FileInfo& info) {
+    Profiler::Scope scope(Profiler::Phase::FORMAT);
+    const std::string& reset = ColorManager::getReset();
+
+    out += FileSystem::getFileColor(info);
+    out += info.name;
+    out += reset;
+
+    if (info.isDirectory) {
+        out += ' ';
+        out += ColorManager::getDirLabelColor();
+        out += "[DIR]";
+        out += reset;
+        out += " | ";
+    } else {
+        out += " (";
+        out += ColorManager::getSizeColor();
+        out += info.sizeFormatted;
+        out += reset;
+        out += ") | ";
+    }
+
+    out += ColorManager::getDateColor();
+    out += info.lastModified;
+    out += reset;
+    out += " | ";
+    out += ColorManager::getPermissionsColor();
+    out += info.permissions;
+    out += reset;
+}
+
+void LineRenderer::appendEntry(std::string_view name, const FileSystem::RawMetadata& meta, bool isSymlink) {
+    appendEntry(line_, name, meta, isSymlink);
+}
+
+void LineRenderer::appendEntry(std::string& out, std::string_view name,
+                               const FileSystem::RawMetadata& meta, bool isSymlink) {
+    Profiler::Scope scope(Profiler::Phase::FORMAT);
+    const std::string& reset = ColorManager::getReset();
+    char buffer[Formatter::TIME_BUFFER_SIZE];
+
+    out += FileSystem::getFileColor(name, meta, isSymlink);
+    out += name;
+    out += reset;
+
+    if (S_ISDIR(meta.mode)) {
+        out += ' ';
+        out += ColorManager::getDirLabelColor();
+        out += "[DIR]";
+        out += reset;
+        out += " | ";
+    } else {
+        out += " (";
+        out += ColorManager::getSizeColor();
+        out.append(buffer, Formatter::formatSize(FileSystem::entrySize(meta), buffer));
+        out += reset;
+        out += ") | ";
+    }
+
+    // mode == 0 - метаданные недоступны, как в FileSystem::makeFileInfo
+    out += ColorManager::getDateColor();
+    if (meta.mode == 0) {
+        out += "N/A";
+    } else {
+        out.append(buffer, Formatter::formatTime(meta.mtimeNs / 1000000000LL, buffer));
+    }
+    out += reset;
+    out += " | ";
+    out += ColorManager::getPermissionsColor();
+    if (meta.mode == 0) {
+        out += "---------";
+    } else {
+        out.append(buffer, Formatter::formatPermissions(meta.mode, buffer));
+    }
+    out += reset;
+}
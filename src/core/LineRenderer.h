@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FileSystem.h"
+
+// Сборка строк дерева в одном переиспользуемом буфере.
+// Отступ хранится стеком сегментов: вход в директорию добавляет
+// "│   " или "    ", выход снимает его, строки префикса не копируются.
+// После прогрева буферов строка строится без выделений памяти.
+class LineRenderer {
+public:
+    void pushLevel(bool isLast);
+    void popLevel();
+    void clear();
+
+    // Начинает новую строку: текущий отступ и соединитель ветки
+    void beginLine(bool isLast);
+    void appendEntry(const FileSystem::FileInfo& info);
+    void appendEntry(std::string_view name, const FileSystem::RawMetadata& meta, bool isSymlink);
+    void append(std::string_view text) { line_ += text; }
+
+    const std::string& line() const { return line_; }
+
+    // Имя, размер или [DIR], дата и права элемента - в конец out
+    static void appendEntry(std::string& out, const FileSystem::FileInfo& info);
+    // То же по сырым метаданным: размер, дата и права форматируются прямо в out,
+    // без промежуточных строк FileInfo
+    static void appendEntry(std::string& out, std::string_view name,
+                            const FileSystem::RawMetadata& meta, bool isSymlink);
+
+private:
+    std::string prefix_;
+    std::vector<size_t> levels_;
+    std::string line_;
+};
@@ -0,0 +1,39 @@
+#include "OutputSink.h"
+#include "Profiler.h"
+
+void OutputSink::writeBlock(const std::string& lines) {
+    size_t start = 0;
+    while (start < lines.size()) {
+        size_t end = lines.find('\n', start);
+        if (end == std::string::npos) {
+            end = lines.size();
+        }
+        writeLine(lines.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+StreamSink::StreamSink(std::ostream& out) : out_(out) {}
+
+void StreamSink::writeLine(const std::string& line) {
+    Profiler::Scope scope(Profiler::Phase::OUTPUT);
+    out_ << line << '\n';
+    bytesWritten_ += line.size() + 1;
+}
+
+void StreamSink::writeBlock(const std::string& lines) {
+    Profiler::Scope scope(Profiler::Phase::OUTPUT);
+    out_.write(lines.data(), static_cast<std::streamsize>(lines.size()));
+    bytesWritten_ += lines.size();
+}
+
+void StreamSink::flush() {
+    Profiler::Scope scope(Profiler::Phase::OUTPUT);
+    out_.flush();
+}
+
+BufferSink::BufferSink(std::vector<std::string>& lines) : lines_(lines) {}
+
+void BufferSink::writeLine(const std::string& line) {
+    lines_.push_back(line);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+
+// Приемник строк дерева. Построитель пишет в него по мере обхода,
+// поэтому вывод начинается сразу и не требует хранить все дерево в памяти.
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+    
+    virtual void writeLine(const std::string& line) = 0;
+    // Несколько строк, каждая с '\n' в конце, одной записью
+    virtual void writeBlock(const std::string& lines);
+    virtual void flush() {}
+};
+
+// Потоковый вывод: консоль или файл
+class StreamSink : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& out);
+    
+    void writeLine(const std::string& line) override;
+    void writeBlock(const std::string& lines) override;
+    void flush() override;
+    
+    uint64_t bytesWritten() const { return bytesWritten_; }
+    
+private:
+    std::ostream& out_;
+    uint64_t bytesWritten_ = 0;
+};
+
+// Накопление строк в памяти (getTreeLines() и тесты)
+class BufferSink : public OutputSink {
+public:
+    explicit BufferSink(std::vector<std::string>& lines);
+    
+    void writeLine(const std::string& line) override;
+    
+private:
+    std::vector<std::string>& lines_;
+};
@@ -0,0 +1,184 @@
+#include "Profiler.h"
+#include "FileSystem.h"
+#include "DirectoryReader.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <time.h>
+#include <sys/resource.h>
+
+std::atomic<bool> Profiler::enabled_{false};
+std::atomic<bool> Profiler::countAllocations_{false};
+std::atomic<uint64_t> Profiler::allocationCount_{0};
+
+namespace {
+    struct ThreadRecord {
+        std::string name;
+        Profiler::PhaseTotals phases[Profiler::PHASE_COUNT];
+    };
+
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadRecord>> registry;
+    std::atomic<uint64_t> generation{0};
+
+    thread_local ThreadRecord* currentRecord = nullptr;
+    thread_local uint64_t recordGeneration = 0;
+    thread_local std::string threadName = "main";
+    thread_local Profiler::Scope* activeScope = nullptr;
+
+    uint64_t startWallNs = 0;
+    uint64_t startCpuNs = 0;
+    uint64_t startStatSyscalls = 0;
+    uint64_t startReaddirSyscalls = 0;
+
+    uint64_t clockNs(clockid_t clock) {
+        timespec ts;
+        clock_gettime(clock, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    ThreadRecord& threadRecord() {
+        uint64_t current = generation.load(std::memory_order_acquire);
+        if (!currentRecord || recordGeneration != current) {
+            auto record = std::make_unique<ThreadRecord>();
+            record->name = threadName;
+            std::lock_guard<std::mutex> lock(registryMutex);
+            registry.push_back(std::move(record));
+            currentRecord = registry.back().get();
+            recordGeneration = current;
+        }
+        return *currentRecord;
+    }
+
+    void addElapsed(Profiler::PhaseTotals& totals, uint64_t wallNs, uint64_t cpuNs) {
+        totals.wallNs += wallNs;
+        totals.cpuNs += cpuNs;
+    }
+
+    void addTotals(Profiler::PhaseTotals& target, const Profiler::PhaseTotals& source) {
+        target.wallNs += source.wallNs;
+        target.cpuNs += source.cpuNs;
+        target.calls += source.calls;
+    }
+}
+
+void Profiler::Scope::begin(Phase phase) {
+    uint64_t wallNow = clockNs(CLOCK_MONOTONIC);
+    uint64_t cpuNow = clockNs(CLOCK_THREAD_CPUTIME_ID);
+
+    parent_ = activeScope;
+    if (parent_) {
+        parent_->pause(wallNow, cpuNow);
+    }
+
+    phase_ = phase;
+    active_ = true;
+    wallStart_ = wallNow;
+    cpuStart_ = cpuNow;
+    activeScope = this;
+}
+
+void Profiler::Scope::end() {
+    uint64_t wallNow = clockNs(CLOCK_MONOTONIC);
+    uint64_t cpuNow = clockNs(CLOCK_THREAD_CPUTIME_ID);
+
+    auto& totals = threadRecord().phases[static_cast<size_t>(phase_)];
+    addElapsed(totals, wallNow - wallStart_, cpuNow - cpuStart_);
+    totals.calls++;
+
+    activeScope = parent_;
+    if (parent_) {
+        parent_->resume(wallNow, cpuNow);
+    }
+}
+
+void Profiler::Scope::pause(uint64_t wallNow, uint64_t cpuNow) {
+    auto& totals = threadRecord().phases[static_cast<size_t>(phase_)];
+    addElapsed(totals, wallNow - wallStart_, cpuNow - cpuStart_);
+}
+
+void Profiler::Scope::resume(uint64_t wallNow, uint64_t cpuNow) {
+    wallStart_ = wallNow;
+    cpuStart_ = cpuNow;
+}
+
+void Profiler::start() {
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.clear();
+    }
+    generation.fetch_add(1, std::memory_order_release);
+
+    allocationCount_.store(0, std::memory_order_relaxed);
+    countAllocations_.store(true, std::memory_order_relaxed);
+    startWallNs = clockNs(CLOCK_MONOTONIC);
+    startCpuNs = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+    startStatSyscalls = FileSystem::getSyscallCount();
+    startReaddirSyscalls = DirectoryReader::getSyscallCount();
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+Profiler::Report Profiler::stop() {
+    enabled_.store(false, std::memory_order_relaxed);
+    countAllocations_.store(false, std::memory_order_relaxed);
+
+    Report report;
+    report.wallNs = clockNs(CLOCK_MONOTONIC) - startWallNs;
+    report.cpuNs = clockNs(CLOCK_PROCESS_CPUTIME_ID) - startCpuNs;
+    report.allocations = allocationCount_.load(std::memory_order_relaxed);
+    report.statSyscalls = FileSystem::getSyscallCount() - startStatSyscalls;
+    report.readdirSyscalls = DirectoryReader::getSyscallCount() - startReaddirSyscalls;
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        report.peakRssKb = static_cast<uint64_t>(usage.ru_maxrss);
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& record : registry) {
+        ThreadReport* thread = nullptr;
+        for (auto& existing : report.threads) {
+            if (existing.name == record->name) {
+                thread = &existing;
+                break;
+            }
+        }
+        if (!thread) {
+            report.threads.push_back(ThreadReport{});
+            thread = &report.threads.back();
+            thread->name = record->name;
+        }
+
+        for (size_t i = 0; i < PHASE_COUNT; ++i) {
+            addTotals(thread->phases[i], record->phases[i]);
+            addTotals(report.phases[i], record->phases[i]);
+        }
+    }
+
+    // main первым, рабочие по возрастанию номера
+    std::sort(report.threads.begin(), report.threads.end(), [](const ThreadReport& a, const ThreadReport& b) {
+        if (a.name.size() != b.name.size()) {
+            return a.name.size() < b.name.size();
+        }
+        return a.name < b.name;
+    });
+
+    return report;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    threadName = name;
+}
+
+const char* Profiler::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::READDIR: return "readdir";
+        case Phase::STAT: return "stat";
+        case Phase::SORT: return "sort";
+        case Phase::FORMAT: return "format";
+        case Phase::JSON: return "json";
+        case Phase::OUTPUT: return "output";
+        case Phase::NETWORK: return "network";
+        default: return "unknown";
+    }
+}
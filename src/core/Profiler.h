@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Профилирование построения по фазам (--profile).
+// Время фазы исключительное: вложенная фаза приостанавливает внешнюю.
+// Пока профилирование выключено, Scope сводится к одной проверке флага.
+class Profiler {
+public:
+    enum class Phase { READDIR, STAT, SORT, FORMAT, JSON, OUTPUT, NETWORK, COUNT };
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(Phase::COUNT);
+
+    struct PhaseTotals {
+        uint64_t wallNs = 0;
+        uint64_t cpuNs = 0;
+        uint64_t calls = 0;
+    };
+
+    struct ThreadReport {
+        std::string name;
+        PhaseTotals phases[PHASE_COUNT];
+    };
+
+    struct Report {
+        uint64_t wallNs = 0;
+        uint64_t cpuNs = 0;
+        uint64_t statSyscalls = 0;
+        uint64_t readdirSyscalls = 0;
+        uint64_t allocations = 0;
+        uint64_t peakRssKb = 0;
+        PhaseTotals phases[PHASE_COUNT];
+        // Потоки с одинаковым именем (рабочие разных пулов) сведены вместе
+        std::vector<ThreadReport> threads;
+    };
+
+    class Scope {
+    public:
+        explicit Scope(Phase phase) {
+            if (enabled_.load(std::memory_order_relaxed)) {
+                begin(phase);
+            }
+        }
+        ~Scope() {
+            if (active_) {
+                end();
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Phase phase_ = Phase::COUNT;
+        bool active_ = false;
+        uint64_t wallStart_ = 0;
+        uint64_t cpuStart_ = 0;
+        Scope* parent_ = nullptr;
+
+        void begin(Phase phase);
+        void end();
+        void pause(uint64_t wallNow, uint64_t cpuNow);
+        void resume(uint64_t wallNow, uint64_t cpuNow);
+    };
+
+    // Сбрасывает накопленные данные и включает сбор
+    static void start();
+    // Выключает сбор; вызывать после завершения рабочих потоков
+    static Report stop();
+    static bool isEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Имя потока в отчете; по умолчанию "main"
+    static void setThreadName(const std::string& name);
+
+    static const char* phaseName(Phase phase);
+
+    // Вызывается заменой operator new (AllocationCounter.cpp), которая
+    // собирается только в tree-utility; без нее в отчете 0 выделений
+    static void recordAllocation() {
+        if (countAllocations_.load(std::memory_order_relaxed)) {
+            allocationCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static std::atomic<bool> enabled_;
+    static std::atomic<bool> countAllocations_;
+    static std::atomic<uint64_t> allocationCount_;
+};
@@ -0,0 +1,199 @@
+#include "ScanIndex.h"
+#include "BinaryIO.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sys/stat.h>
+
+namespace {
+    using binary::put;
+    using binary::putString;
+
+    constexpr char MAGIC[8] = {'T', 'U', 'I', 'N', 'D', 'E', 'X', '1'};
+    // 2: без метаданных элементов
+    constexpr uint32_t FORMAT_VERSION = 2;
+
+    // Директория, измененная меньше секунды назад, в индекс не попадает:
+    // изменение в тот же тик времени не изменило бы ее mtime
+    constexpr int64_t RACY_WINDOW_NS = 1000000000LL;
+
+    // Последний stat директории в потоке: обход делает его прямо перед
+    // чтением каталога, повторять не нужно
+    struct LastDirectory {
+        std::string path;
+        FileSystem::RawMetadata meta;
+    };
+    thread_local LastDirectory lastDirectory;
+
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::string stripTrailingSlashes(std::string text) {
+        while (text.size() > 1 && text.back() == '/') {
+            text.pop_back();
+        }
+        return text;
+    }
+}
+
+ScanIndex::ScanIndex(std::shared_ptr<FileSystemProvider> inner, const fs::path& indexPath)
+    : inner_(std::move(inner)), indexPath_(indexPath) {
+    std::error_code ec;
+    currentDirectory_ = fs::current_path(ec).native();
+}
+
+void ScanIndex::load() {
+    std::ifstream file(indexPath_, std::ios::binary);
+    if (!file) {
+        return;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    binary::Reader reader(data);
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    uint64_t recordCount = 0;
+    bool ok = reader.get(magic) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 &&
+              reader.get(version) && version == FORMAT_VERSION && reader.get(recordCount);
+
+    std::unordered_map<std::string, Record> records;
+    for (uint64_t i = 0; ok && i < recordCount; ++i) {
+        std::string key;
+        Record record;
+        uint64_t childCount = 0;
+        ok = reader.getString(key) && reader.get(record.mtimeNs) && reader.get(record.inode) &&
+             reader.get(childCount);
+
+        for (uint64_t c = 0; ok && c < childCount; ++c) {
+            DirectoryReader::Entry child;
+            uint8_t type = 0;
+            ok = reader.getString(child.name) && reader.get(type) && reader.get(child.inode);
+            child.type = static_cast<DirectoryReader::EntryType>(type);
+            record.children.push_back(std::move(child));
+        }
+        if (ok) {
+            records[std::move(key)] = std::move(record);
+        }
+    }
+
+    if (!ok || !reader.atEnd()) {
+        std::cerr << "Предупреждение: индекс " << indexPath_.string()
+                  << " поврежден или несовместим, выполняется полное сканирование" << std::endl;
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    records_ = std::move(records);
+}
+
+bool ScanIndex::save() const {
+    std::string data;
+    data.append(MAGIC, sizeof(MAGIC));
+    put(data, FORMAT_VERSION);
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    put<uint64_t>(data, records_.size());
+    for (const auto& [key, record] : records_) {
+        putString(data, key);
+        put(data, record.mtimeNs);
+        put(data, record.inode);
+        put<uint64_t>(data, record.children.size());
+        for (const auto& child : record.children) {
+            putString(data, child.name);
+            put<uint8_t>(data, static_cast<uint8_t>(child.type));
+            put(data, child.inode);
+        }
+    }
+    lock.unlock();
+
+    // Запись через временный файл: прерванный запуск не портит старый индекс
+    fs::path temporary = indexPath_;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+            std::cerr << "Ошибка: не удалось записать индекс " << temporary.string() << std::endl;
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporary, indexPath_, ec);
+    if (ec) {
+        std::cerr << "Ошибка: не удалось заменить индекс " << indexPath_.string() << ": " << ec.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string ScanIndex::absoluteKey(const fs::path& path) const {
+    if (path.is_absolute()) {
+        return stripTrailingSlashes(path.lexically_normal().native());
+    }
+    return stripTrailingSlashes((fs::path(currentDirectory_) / path).lexically_normal().native());
+}
+
+bool ScanIndex::readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) {
+    FileSystem::RawMetadata meta;
+    if (lastDirectory.path == path.native()) {
+        meta = lastDirectory.meta;
+    } else if (!inner_->readMetadata(path, meta, true)) {
+        return inner_->readEntries(path, entries);
+    }
+
+    std::string key = absoluteKey(path);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = records_.find(key);
+        if (it != records_.end() && it->second.mtimeNs == meta.mtimeNs && it->second.inode == meta.inode) {
+            entries.insert(entries.end(), it->second.children.begin(), it->second.children.end());
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    size_t first = entries.size();
+    if (!inner_->readEntries(path, entries)) {
+        return false;
+    }
+    if (meta.mtimeNs > nowNs() - RACY_WINDOW_NS) {
+        // Прежняя запись устарела, а новую заводить рано
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        records_.erase(key);
+        return true;
+    }
+
+    Record record;
+    record.mtimeNs = meta.mtimeNs;
+    record.inode = meta.inode;
+    record.children.assign(entries.begin() + static_cast<std::ptrdiff_t>(first), entries.end());
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    records_[key] = std::move(record);
+    return true;
+}
+
+bool ScanIndex::readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool followSymlinks) {
+    if (!inner_->readMetadata(path, meta, followSymlinks)) {
+        return false;
+    }
+    if (S_ISDIR(meta.mode)) {
+        lastDirectory.path = path.native();
+        lastDirectory.meta = meta;
+    }
+    return true;
+}
+
+void ScanIndex::readMetadataBatch(const std::vector<const fs::path*>& paths,
+                                  std::vector<FileSystem::RawMetadata>& metas) {
+    inner_->readMetadataBatch(paths, metas);
+}
+
+bool ScanIndex::readFile(const fs::path& path, std::string& contents) {
+    return inner_->readFile(path, contents);
+}
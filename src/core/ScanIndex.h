@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "FileSystemProvider.h"
+
+// Постоянный индекс сканирования (--index PATH).
+// Оборачивает провайдера: для каждой директории хранит листинг вместе
+// с mtime и inode директории. Если при следующем запуске mtime и inode
+// совпали, листинг берется из индекса без чтения каталога. Метаданные
+// элементов не кэшируются: запись в файл на месте mtime директории
+// не меняет, поэтому stat всегда идет через внутреннего провайдера.
+class ScanIndex : public FileSystemProvider {
+public:
+    ScanIndex(std::shared_ptr<FileSystemProvider> inner, const fs::path& indexPath);
+
+    // Загружает индекс; отсутствующий файл - пустой индекс, поврежденный - с предупреждением
+    void load();
+    // Записывает индекс атомарно (через временный файл и rename)
+    bool save() const;
+
+    bool readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) override;
+    bool readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool followSymlinks) override;
+    void readMetadataBatch(const std::vector<const fs::path*>& paths,
+                           std::vector<FileSystem::RawMetadata>& metas) override;
+    bool readFile(const fs::path& path, std::string& contents) override;
+
+    // Директорий из индекса и прочитанных заново за этот запуск
+    size_t getHitCount() const { return hits_.load(std::memory_order_relaxed); }
+    size_t getMissCount() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Record {
+        int64_t mtimeNs = 0;
+        uint64_t inode = 0;
+        std::vector<DirectoryReader::Entry> children;
+    };
+
+    std::shared_ptr<FileSystemProvider> inner_;
+    fs::path indexPath_;
+    std::string currentDirectory_;
+
+    mutable std::shared_mutex mutex_;
+    // Ключ - абсолютный нормализованный путь директории
+    std::unordered_map<std::string, Record> records_;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    std::string absoluteKey(const fs::path& path) const;
+};
@@ -0,0 +1,314 @@
+#include "SyntheticFileSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <sys/stat.h>
+#include <thread>
+
+namespace {
+    const char NAME_ALPHABET[] = "abcdefghijklmnopqrstuvwxyz0123456789_-";
+    const char* const FILE_EXTENSIONS[] = {".txt", ".cpp", ".h", ".json", ".log", ".png", ".tar.gz", ".md", ""};
+
+    // Время изменения - в пределах трех лет до этой даты
+    constexpr int64_t NEWEST_MTIME = 1700000000;
+    constexpr int64_t MTIME_SPAN = 3 * 365 * 86400;
+
+    std::string toBase36(size_t value) {
+        std::string digits;
+        do {
+            digits += NAME_ALPHABET[value % 36];
+            value /= 36;
+        } while (value > 0);
+        return std::string(digits.rbegin(), digits.rend());
+    }
+
+    bool parseUnsigned(std::string_view text, uint64_t& value) {
+        if (text.empty()) {
+            return false;
+        }
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+        return true;
+    }
+
+    // Число с необязательным суффиксом K, M или G (степени 1024)
+    bool parseSizeValue(std::string_view text, uint64_t& value) {
+        uint64_t multiplier = 1;
+        if (!text.empty()) {
+            switch (text.back()) {
+                case 'K': case 'k': multiplier = constants::KB; break;
+                case 'M': case 'm': multiplier = constants::MB; break;
+                case 'G': case 'g': multiplier = constants::GB; break;
+                default: break;
+            }
+            if (multiplier != 1) {
+                text.remove_suffix(1);
+            }
+        }
+        if (!parseUnsigned(text, value)) {
+            return false;
+        }
+        value *= multiplier;
+        return true;
+    }
+
+    // Длительность с суффиксом us, ms или s; без суффикса - микросекунды
+    bool parseLatency(std::string_view text, std::chrono::microseconds& latency) {
+        uint64_t multiplier = 1;
+        if (text.size() > 2 && text.substr(text.size() - 2) == "us") {
+            text.remove_suffix(2);
+        } else if (text.size() > 2 && text.substr(text.size() - 2) == "ms") {
+            multiplier = 1000;
+            text.remove_suffix(2);
+        } else if (text.size() > 1 && text.back() == 's') {
+            multiplier = 1000000;
+            text.remove_suffix(1);
+        }
+        uint64_t value = 0;
+        if (!parseUnsigned(text, value)) {
+            return false;
+        }
+        latency = std::chrono::microseconds(value * multiplier);
+        return true;
+    }
+
+    // "MIN-MAX" или одно значение для обеих границ
+    template <typename Parse>
+    bool parseRange(std::string_view text, uint64_t& low, uint64_t& high, Parse parse) {
+        size_t dash = text.find('-');
+        if (dash == std::string_view::npos) {
+            if (!parse(text, low)) {
+                return false;
+            }
+            high = low;
+            return true;
+        }
+        return parse(text.substr(0, dash), low) && parse(text.substr(dash + 1), high) && low <= high;
+    }
+
+    void simulateLatency(std::chrono::microseconds latency) {
+        if (latency.count() > 0) {
+            std::this_thread::sleep_for(latency);
+        }
+    }
+}
+
+bool SyntheticFileSystem::parseSpec(const std::string& text, Spec& spec) {
+    std::string_view rest(text);
+    while (!rest.empty()) {
+        size_t end = rest.find(',');
+        std::string_view item = rest.substr(0, end);
+        rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+        if (item.empty()) {
+            continue;
+        }
+
+        size_t eq = item.find('=');
+        std::string_view key = item.substr(0, eq);
+        std::string_view value = eq == std::string_view::npos ? std::string_view() : item.substr(eq + 1);
+        uint64_t number = 0;
+        uint64_t upper = 0;
+        bool ok = true;
+
+        if (key == "fanout") {
+            ok = parseUnsigned(value, number);
+            spec.fanOut = number;
+        } else if (key == "depth") {
+            ok = parseUnsigned(value, number);
+            spec.depth = number;
+        } else if (key == "files") {
+            ok = parseUnsigned(value, number);
+            spec.filesPerDirectory = number;
+        } else if (key == "size") {
+            ok = parseRange(value, spec.minFileSize, spec.maxFileSize, parseSizeValue);
+        } else if (key == "name") {
+            ok = parseRange(value, number, upper, parseUnsigned) && number > 0;
+            spec.minNameLength = number;
+            spec.maxNameLength = upper;
+        } else if (key == "latency") {
+            ok = parseLatency(value, spec.statLatency);
+            spec.readdirLatency = spec.statLatency;
+        } else if (key == "stat-latency") {
+            ok = parseLatency(value, spec.statLatency);
+        } else if (key == "readdir-latency") {
+            ok = parseLatency(value, spec.readdirLatency);
+        } else if (key == "seed") {
+            ok = parseUnsigned(value, spec.seed);
+        } else {
+            std::cerr << "Ошибка: неизвестный параметр синтетического дерева: " << key << std::endl;
+            return false;
+        }
+
+        if (!ok) {
+            std::cerr << "Ошибка: неверное значение параметра синтетического дерева: " << item << std::endl;
+            return false;
+        }
+    }
+
+    // Число узлов: директории всех уровней и файлы в каждой из них
+    double directories = 0;
+    for (size_t level = 0, count = 1; level <= spec.depth; ++level) {
+        directories += static_cast<double>(count);
+        count *= std::max<size_t>(spec.fanOut, 1);
+        if (directories > MAX_NODES) {
+            break;
+        }
+    }
+    if (directories * static_cast<double>(spec.filesPerDirectory + 1) > MAX_NODES) {
+        std::cerr << "Ошибка: синтетическое дерево больше " << MAX_NODES << " элементов" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+SyntheticFileSystem::SyntheticFileSystem(const Spec& spec, const fs::path& mountPoint)
+    : spec_(spec), mountPoint_(mountPoint.native()) {
+    // "dir/" и "dir" - один корень
+    while (mountPoint_.size() > 1 && mountPoint_.back() == '/') {
+        mountPoint_.pop_back();
+    }
+    generate();
+}
+
+void SyntheticFileSystem::generate() {
+    std::mt19937_64 rng(spec_.seed);
+    std::uniform_int_distribution<size_t> nameLength(spec_.minNameLength, spec_.maxNameLength);
+    std::uniform_int_distribution<size_t> nameChar(0, sizeof(NAME_ALPHABET) - 2);
+    std::uniform_real_distribution<double> logSize(std::log(static_cast<double>(spec_.minFileSize) + 1),
+                                                   std::log(static_cast<double>(spec_.maxFileSize) + 1));
+    std::uniform_int_distribution<int64_t> mtime(0, MTIME_SPAN * 1000000000LL);
+
+    auto makeName = [&](size_t index, const char* extension) {
+        // Суффикс с номером делает имена соседей уникальными
+        std::string suffix = "_" + toBase36(index) + extension;
+        size_t length = nameLength(rng);
+        size_t body = length > suffix.size() ? length - suffix.size() : 1;
+        std::string name;
+        name.reserve(body + suffix.size());
+        for (size_t i = 0; i < body; ++i) {
+            name += NAME_ALPHABET[nameChar(rng)];
+        }
+        return name + suffix;
+    };
+
+    nodes_.clear();
+    nodes_.emplace_back();
+    nodes_[0].meta.mode = S_IFDIR | 0755;
+    nodes_[0].meta.mtimeNs = NEWEST_MTIME * 1000000000LL;
+    nodes_[0].meta.inode = 1;
+    nodes_[0].meta.nlink = 2;
+    std::vector<uint32_t> levels{0};
+    fileCount_ = 0;
+    directoryCount_ = 0;
+
+    // Обход в ширину: дети каждого узла добавляются подряд
+    for (size_t parent = 0; parent < nodes_.size(); ++parent) {
+        if (!S_ISDIR(nodes_[parent].meta.mode)) {
+            continue;
+        }
+        size_t directories = levels[parent] < spec_.depth ? spec_.fanOut : 0;
+        size_t first = nodes_.size();
+
+        for (size_t i = 0; i < directories + spec_.filesPerDirectory; ++i) {
+            Node node;
+            bool isDirectory = i < directories;
+            int64_t modified = NEWEST_MTIME * 1000000000LL - mtime(rng);
+            node.meta.mtimeNs = modified;
+            node.meta.inode = nodes_.size() + 1;
+            if (isDirectory) {
+                node.name = makeName(i, "");
+                node.meta.mode = S_IFDIR | 0755;
+                node.meta.nlink = 2;
+                directoryCount_++;
+            } else {
+                node.name = makeName(i, FILE_EXTENSIONS[rng() % (sizeof(FILE_EXTENSIONS) / sizeof(FILE_EXTENSIONS[0]))]);
+                node.meta.mode = S_IFREG | (rng() % 16 == 0 ? 0755 : 0644);
+                node.meta.size = static_cast<uint64_t>(std::exp(logSize(rng))) - 1;
+                node.meta.nlink = 1;
+                fileCount_++;
+            }
+            nodes_.push_back(std::move(node));
+            levels.push_back(levels[parent] + 1);
+        }
+
+        std::sort(nodes_.begin() + first, nodes_.end(), [](const Node& a, const Node& b) {
+            return a.name < b.name;
+        });
+        // Сортировка переставила узлы одного уровня - уровни совпадают
+        nodes_[parent].firstChild = static_cast<uint32_t>(first);
+        nodes_[parent].childCount = static_cast<uint32_t>(nodes_.size() - first);
+    }
+}
+
+int64_t SyntheticFileSystem::resolve(const fs::path& path) const {
+    std::string_view full(path.native());
+    if (full.compare(0, mountPoint_.size(), mountPoint_) != 0) {
+        return -1;
+    }
+    std::string_view rest = full.substr(mountPoint_.size());
+    if (!rest.empty() && rest[0] != '/' && mountPoint_ != "/") {
+        return -1;
+    }
+
+    size_t index = 0;
+    while (!rest.empty()) {
+        size_t slash = rest.find('/');
+        std::string_view component = rest.substr(0, slash);
+        rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+        if (component.empty() || component == ".") {
+            continue;
+        }
+
+        const Node& node = nodes_[index];
+        auto begin = nodes_.begin() + node.firstChild;
+        auto end = begin + node.childCount;
+        auto it = std::lower_bound(begin, end, component, [](const Node& child, std::string_view name) {
+            return std::string_view(child.name) < name;
+        });
+        if (it == end || it->name != component) {
+            return -1;
+        }
+        index = static_cast<size_t>(it - nodes_.begin());
+    }
+    return static_cast<int64_t>(index);
+}
+
+bool SyntheticFileSystem::readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) {
+    simulateLatency(spec_.readdirLatency);
+
+    int64_t index = resolve(path);
+    if (index < 0 || !S_ISDIR(nodes_[index].meta.mode)) {
+        return false;
+    }
+
+    const Node& node = nodes_[index];
+    entries.reserve(entries.size() + node.childCount);
+    for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+        DirectoryReader::Entry entry;
+        entry.name = nodes_[i].name;
+        entry.type = S_ISDIR(nodes_[i].meta.mode) ? DirectoryReader::EntryType::DIRECTORY
+                                                  : DirectoryReader::EntryType::REGULAR;
+        entry.inode = nodes_[i].meta.inode;
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+bool SyntheticFileSystem::readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool) {
+    simulateLatency(spec_.statLatency);
+
+    // Симлинков в синтетическом дереве нет: followSymlinks ничего не меняет
+    int64_t index = resolve(path);
+    if (index < 0) {
+        return false;
+    }
+    meta = nodes_[index].meta;
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FileSystemProvider.h"
+
+// Синтетическое дерево в памяти для профилирования обхода, сортировки,
+// форматирования и вывода без ядра и page cache. Дерево детерминированно
+// строится по спецификации и монтируется в заданный корень: пути под ним
+// разрешаются в узлы, остальные считаются несуществующими.
+// Задержка на вызов имитирует медленное хранилище (NFS и т.п.).
+class SyntheticFileSystem : public FileSystemProvider {
+public:
+    struct Spec {
+        size_t fanOut = 4;                  // поддиректорий в каждой директории
+        size_t depth = 4;                   // уровней директорий под корнем
+        size_t filesPerDirectory = 16;
+        uint64_t minFileSize = 1024;        // размеры распределены лог-равномерно
+        uint64_t maxFileSize = 1024 * 1024;
+        size_t minNameLength = 8;
+        size_t maxNameLength = 16;
+        std::chrono::microseconds readdirLatency{0};
+        std::chrono::microseconds statLatency{0};
+        uint64_t seed = 1;
+    };
+
+    // Разбирает "fanout=8,depth=3,files=100,size=1K-4M,name=6-20,latency=200us,seed=7".
+    // Ключи stat-latency и readdir-latency задают задержки по отдельности.
+    static bool parseSpec(const std::string& text, Spec& spec);
+
+    SyntheticFileSystem(const Spec& spec, const fs::path& mountPoint);
+
+    bool readEntries(const fs::path& path, std::vector<DirectoryReader::Entry>& entries) override;
+    bool readMetadata(const fs::path& path, FileSystem::RawMetadata& meta, bool followSymlinks) override;
+
+    size_t fileCount() const { return fileCount_; }
+    size_t directoryCount() const { return directoryCount_; }
+
+    // Больше узлов не строится: спецификация с ошибкой в порядке величины
+    static constexpr size_t MAX_NODES = 50'000'000;
+
+private:
+    // Дети узла лежат в nodes_ подряд и отсортированы по имени
+    struct Node {
+        std::string name;
+        uint32_t firstChild = 0;
+        uint32_t childCount = 0;
+        FileSystem::RawMetadata meta;
+    };
+
+    Spec spec_;
+    std::string mountPoint_;
+    std::vector<Node> nodes_;
+    size_t fileCount_ = 0;
+    size_t directoryCount_ = 0;
+
+    void generate();
+    // Индекс узла или -1, если путь вне дерева
+    int64_t resolve(const fs::path& path) const;
+};
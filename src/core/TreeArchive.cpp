@@ -0,0 +1,178 @@
+#include "TreeArchive.h"
+#include "BinaryIO.h"
+#include <cstring>
+#include <fstream>
+
+namespace {
+    using binary::put;
+    using binary::putArray;
+
+    constexpr char MAGIC[8] = {'T', 'U', 'T', 'R', 'E', 'E', 'B', '1'};
+    constexpr uint32_t FORMAT_VERSION = 1;
+
+    constexpr uint32_t tag(const char (&name)[5]) {
+        return static_cast<uint32_t>(static_cast<uint8_t>(name[0])) |
+               static_cast<uint32_t>(static_cast<uint8_t>(name[1])) << 8 |
+               static_cast<uint32_t>(static_cast<uint8_t>(name[2])) << 16 |
+               static_cast<uint32_t>(static_cast<uint8_t>(name[3])) << 24;
+    }
+    constexpr uint32_t TAG_NODE = tag("NODE");
+    constexpr uint32_t TAG_NAME = tag("NAME");
+    constexpr uint32_t TAG_STAT = tag("STAT");
+
+    // Флаг архива поверх флагов модели: содержимое директории не выводится
+    constexpr uint8_t FLAG_CUT = 0x80;
+
+    void putSection(std::string& out, uint32_t sectionTag, const std::string& payload) {
+        put(out, sectionTag);
+        put<uint64_t>(out, payload.size());
+        out += payload;
+    }
+}
+
+bool TreeArchive::write(std::ostream& out, const TreeModel& model, const TreeView& view,
+                        const TreeBuilder::Statistics& stats, size_t hiddenObjects,
+                        size_t ignoredObjects) {
+    // Родитель добавлен в модель раньше детей, поэтому один проход
+    // по индексам сохраняет и этот порядок, и блоки детей
+    std::vector<TreeModel::Index> remap(model.size(), TreeModel::NONE);
+    std::vector<TreeModel::Index> parents;
+    std::vector<uint64_t> sizes;
+    std::vector<int64_t> mtimesNs;
+    std::vector<uint32_t> modes;
+    std::vector<uint8_t> flags;
+    std::vector<uint64_t> nameOffsets{0};
+    std::string names;
+    parents.reserve(model.size());
+    sizes.reserve(model.size());
+    mtimesNs.reserve(model.size());
+    modes.reserve(model.size());
+    flags.reserve(model.size());
+    nameOffsets.reserve(model.size() + 1);
+
+    for (TreeModel::Index node = 0; node < model.size(); ++node) {
+        TreeModel::Index parent = TreeModel::NONE;
+        if (node != TreeModel::ROOT) {
+            TreeView::State state = view.state(node);
+            parent = remap[model.parent(node)];
+            if (parent == TreeModel::NONE || view.state(model.parent(node)) != TreeView::State::SHOWN ||
+                state == TreeView::State::HIDDEN || state == TreeView::State::PLACEHOLDER) {
+                continue;
+            }
+        }
+        remap[node] = static_cast<TreeModel::Index>(parents.size());
+        parents.push_back(parent);
+        sizes.push_back(model.isDirectory(node) ? 0 : model.fileSize(node));
+        mtimesNs.push_back(model.mtimeNs(node));
+        modes.push_back(model.mode(node));
+        flags.push_back(model.flags(node) | (view.state(node) == TreeView::State::CUT ? FLAG_CUT : 0));
+        names += model.name(node);
+        nameOffsets.push_back(names.size());
+    }
+    for (size_t node = parents.size(); node-- > 1;) {
+        sizes[parents[node]] += sizes[node];
+    }
+
+    std::string data;
+    data.append(MAGIC, sizeof(MAGIC));
+    put(data, FORMAT_VERSION);
+
+    std::string payload;
+    put<uint32_t>(payload, static_cast<uint32_t>(parents.size()));
+    putArray(payload, parents);
+    putArray(payload, sizes);
+    putArray(payload, mtimesNs);
+    putArray(payload, modes);
+    putArray(payload, flags);
+    putSection(data, TAG_NODE, payload);
+
+    payload.clear();
+    putArray(payload, nameOffsets);
+    payload += names;
+    putSection(data, TAG_NAME, payload);
+
+    payload.clear();
+    put<uint64_t>(payload, stats.totalDirectories);
+    put<uint64_t>(payload, stats.totalFiles);
+    put<uint64_t>(payload, stats.totalSize);
+    put<uint64_t>(payload, hiddenObjects);
+    put<uint64_t>(payload, ignoredObjects);
+    putSection(data, TAG_STAT, payload);
+
+    return static_cast<bool>(out.write(data.data(), static_cast<std::streamsize>(data.size())));
+}
+
+bool TreeArchive::read(std::string_view data, Tree& tree) {
+    binary::Reader reader(data);
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0;
+    if (!reader.get(magic) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !reader.get(version) || version != FORMAT_VERSION) {
+        return false;
+    }
+
+    uint32_t count = 0;
+    std::vector<TreeModel::Index> parents;
+    std::vector<uint64_t> sizes;
+    std::vector<int64_t> mtimesNs;
+    std::vector<uint32_t> modes;
+    std::vector<uint8_t> flags;
+    std::vector<uint64_t> nameOffsets;
+    std::string_view names;
+    bool hasNodes = false;
+    bool hasNames = false;
+    bool hasStats = false;
+    uint64_t directories = 0;
+    uint64_t files = 0;
+
+    while (!reader.atEnd()) {
+        uint32_t sectionTag = 0;
+        uint64_t length = 0;
+        std::string_view payload;
+        if (!reader.get(sectionTag) || !reader.get(length) || !reader.getBytes(payload, length)) {
+            return false;
+        }
+
+        binary::Reader section(payload);
+        if (sectionTag == TAG_NODE) {
+            hasNodes = section.get(count) && section.getArray(parents, count) &&
+                       section.getArray(sizes, count) && section.getArray(mtimesNs, count) &&
+                       section.getArray(modes, count) && section.getArray(flags, count);
+        } else if (sectionTag == TAG_NAME) {
+            // Число смещений известно только из NODE, она пишется первой
+            hasNames = hasNodes && section.getArray(nameOffsets, size_t{count} + 1) &&
+                       section.getBytes(names, section.remaining());
+        } else if (sectionTag == TAG_STAT) {
+            hasStats = section.get(directories) && section.get(files) && section.get(tree.stats.totalSize);
+            // Счетчики в конце секции необязательны: их нет в файлах старых версий
+            uint64_t hidden = 0;
+            uint64_t ignored = 0;
+            tree.hiddenObjects = hasStats && section.get(hidden) ? static_cast<size_t>(hidden) : 0;
+            tree.ignoredObjects = hasStats && section.get(ignored) ? static_cast<size_t>(ignored) : 0;
+        }
+    }
+    if (!hasNodes || !hasNames || !hasStats) {
+        return false;
+    }
+    tree.stats.totalDirectories = static_cast<size_t>(directories);
+    tree.stats.totalFiles = static_cast<size_t>(files);
+
+    tree.view.states.resize(count);
+    for (uint32_t node = 0; node < count; ++node) {
+        tree.view.states[node] = (flags[node] & FLAG_CUT) ? TreeView::State::CUT : TreeView::State::SHOWN;
+        flags[node] &= ~FLAG_CUT;
+    }
+    return tree.model.assign(std::string(names), std::move(nameOffsets), std::move(parents), std::move(sizes),
+                             std::move(mtimesNs), std::move(modes), std::move(flags));
+}
+
+bool TreeArchive::load(const std::string& filename, Tree& tree) {
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    // Файл целиком одним чтением: дальше только копирование столбцов
+    std::string data(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    return file.read(data.data(), static_cast<std::streamsize>(data.size())) && read(data, tree);
+}
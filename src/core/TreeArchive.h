@@ -0,0 +1,39 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "TreeBuilder.h"
+#include "TreeModel.h"
+#include "TreeView.h"
+
+// Двоичный экспорт дерева (--format bin) и его чтение.
+// Файл - магия и версия, затем секции "тег, длина, данные"; секции
+// с неизвестным тегом пропускаются, так что их можно добавлять без смены версии.
+//   NODE - число узлов и столбцы: родитель, размер, mtime (нс), режим, флаги;
+//   NAME - смещения имен (узлов + 1) и пул имен, имя корня - путь;
+//   STAT - статистика: директории, файлы, суммарный размер, затем
+//          необязательные счетчики скрытых и пропущенных по .gitignore
+//          объектов; в файлах старых версий их нет, отсутствующий - 0.
+// Числа - little-endian независимо от машины, так что файл переносим.
+// Столбцы совпадают с массивами TreeModel и на little-endian машине
+// читаются в нее копированием, без разбора по узлам.
+class TreeArchive {
+public:
+    struct Tree {
+        TreeModel model;
+        TreeView view;
+        TreeBuilder::Statistics stats;
+        size_t hiddenObjects = 0;
+        size_t ignoredObjects = 0;
+    };
+
+    // Пишутся только узлы вида; размер директории - сумма показанного
+    // поддерева (как в JSON), директория на границе глубины помечается
+    static bool write(std::ostream& out, const TreeModel& model, const TreeView& view,
+                      const TreeBuilder::Statistics& stats, size_t hiddenObjects,
+                      size_t ignoredObjects);
+    // Разбор файла, уже прочитанного в память; false - поврежден или несовместим
+    static bool read(std::string_view data, Tree& tree);
+    // Чтение файла; false - не открылся, поврежден или несовместим
+    static bool load(const std::string& filename, Tree& tree);
+};
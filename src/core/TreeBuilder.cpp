@@ -1,10 +1,14 @@
 #include "TreeBuilder.h"
 #include "Constants.h"
+#include "DirectoryReader.h"
 #include <iostream>
 #include <algorithm>
+#include <sys/stat.h>
 
 namespace fs = std::filesystem;
 
+std::shared_ptr<IgnoreRules> TreeBuilder::ignoreRules_;
+
 TreeBuilder::TreeBuilder(const std::string& rootPath) : rootPath_(rootPath) {}
 
 void TreeBuilder::buildTree(bool showHidden) {
@@ -14,93 +18,183 @@ void TreeBuilder::buildTree(bool showHidden) {
     stats_ = Statistics{0, 0, 0};
     displayStats_ = DisplayStatistics{};
     hiddenObjectsCount_ = 0;
+    ignoredObjectsCount_ = 0;
+    uint64_t syscallsBefore = FileSystem::getSyscallCount();
 
-    treeLines_.push_back(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
-    traverseDirectory(rootPath_, "", true, showHidden, true);
+    renderer_.clear();
+    emitLine(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+    traverseDirectory(rootPath_, true, showHidden, true);
     
     auto endTime = std::chrono::high_resolution_clock::now();
     displayStats_.buildTimeMicroseconds = 
         std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count();
+    displayStats_.metadataSyscalls = FileSystem::getSyscallCount() - syscallsBefore;
 }
 
-void TreeBuilder::traverseDirectory(const fs::path& path, 
-                                  const std::string& prefix, 
-                                  bool isLast,
-                                  bool showHidden,
-                                  bool isRoot) {
+uint64_t TreeBuilder::traverseDirectory(const fs::path& path, 
+                                      bool isLast,
+                                      bool showHidden,
+                                      bool isRoot) {
     if (!isRoot) {
-        auto info = FileSystem::getFileInfo(path);
-        std::string connector = isLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-        
-        treeLines_.push_back(prefix + connector + formatTreeLine(info, connector));
+        renderDirectoryLine(path, isLast);
+        emitLine(renderer_.line());
         stats_.totalDirectories++;
         displayStats_.displayedDirectories++;
     }
     
-    std::string newPrefix = prefix;
-    if (isLast) {
-        newPrefix += constants::TREE_SPACE;
-    } else {
-        newPrefix += constants::TREE_VERTICAL;
+    std::vector<DirEntry> entries;
+    if (!listDirectory(path, showHidden, entries)) {
+        return 0;
     }
     
-    std::vector<fs::directory_entry> entries;
+    sortEntries(entries);
     
-    try {
-        for (const auto& entry : fs::directory_iterator(path)) {
-            bool isHidden = FileSystem::isHidden(entry.path());
-            
-            if (!isHidden || showHidden) {
-                entries.push_back(entry);
-            } else {
-                hiddenObjectsCount_++;
-            }
-        }
-    } catch (const fs::filesystem_error&) {
-        return;
-    }
-    
-    // Сортировка: сначала директории, потом файлы
-    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
-        if (a.is_directory() != b.is_directory()) {
-            return a.is_directory() > b.is_directory();
-        }
-        return a.path().filename().string() < b.path().filename().string();
-    });
+    uint64_t subtreeSize = 0;
+    MetadataBatch files(entries);
+    renderer_.pushLevel(isLast);
     
     for (size_t i = 0; i < entries.size(); ++i) {
         const auto& entry = entries[i];
         bool entryIsLast = (i == entries.size() - 1);
         
-        if (entry.is_directory()) {
-            traverseDirectory(entry.path(), newPrefix, entryIsLast, showHidden, false);
+        if (entry.isDirectory) {
+            subtreeSize += traverseDirectory(entry.path, entryIsLast, showHidden, false);
         } else {
-            auto info = FileSystem::getFileInfo(entry.path());
-            std::string connector = entryIsLast ? constants::TREE_LAST_BRANCH : constants::TREE_BRANCH;
-            
-            treeLines_.push_back(newPrefix + connector + formatTreeLine(info, connector));
+            const auto& meta = files.at(i);
+            uint64_t size = FileSystem::entrySize(meta);
+            renderEntryLine(entry.name, meta, files.isSymlink(i), entryIsLast);
+            emitLine(renderer_.line());
             stats_.totalFiles++;
-            stats_.totalSize += info.size;
+            stats_.totalSize += size;
             displayStats_.displayedFiles++;
-            displayStats_.displayedSize += info.size;
+            displayStats_.displayedSize += size;
+            subtreeSize += size;
+        }
+    }
+    
+    renderer_.popLevel();
+    return subtreeSize;
+}
+
+const FileSystem::RawMetadata& TreeBuilder::MetadataBatch::at(size_t index) {
+    if (index < first_ || index >= first_ + metas_.size()) {
+        first_ = index;
+        size_t end = std::min(index + BATCH_SIZE, entries_.size());
+        paths_.clear();
+        for (size_t i = index; i < end; ++i) {
+            paths_.push_back(&entries_[i].path);
         }
+        FileSystem::resolveMetadataBatch(paths_, metas_, symlinks_);
     }
+    return metas_[index - first_];
+}
+
+void TreeBuilder::renderEntryLine(const FileSystem::FileInfo& info, bool isLast) {
+    renderer_.beginLine(isLast);
+    renderer_.appendEntry(info);
 }
 
-std::string TreeBuilder::formatTreeLine(const FileSystem::FileInfo& info, 
-                                      const std::string& connector) const {
-    std::string nameColor = FileSystem::getFileColor(info);  
-    if (info.isDirectory) {
-        return nameColor + info.name + ColorManager::getReset() + " " + 
-               ColorManager::getDirLabelColor() + "[DIR]" + ColorManager::getReset() + " | " + 
-               ColorManager::getDateColor() + info.lastModified + ColorManager::getReset() + " | " + 
-               ColorManager::getPermissionsColor() + info.permissions + ColorManager::getReset();
+void TreeBuilder::renderEntryLine(std::string_view name, const FileSystem::RawMetadata& meta,
+                                  bool isSymlink, bool isLast) {
+    renderer_.beginLine(isLast);
+    renderer_.appendEntry(name, meta, isSymlink);
+}
+
+void TreeBuilder::renderDirectoryLine(const fs::path& path, bool isLast) {
+    FileSystem::RawMetadata meta;
+    bool isSymlink = false;
+    FileSystem::resolveMetadata(path, meta, isSymlink);
+    renderEntryLine(FileSystem::fileName(path), meta, isSymlink, isLast);
+}
+
+void TreeBuilder::emitLine(const std::string& line) {
+    if (sink_) {
+        sink_->writeLine(line);
     } else {
-        return nameColor + info.name + ColorManager::getReset() + " (" + 
-               ColorManager::getSizeColor() + info.sizeFormatted + ColorManager::getReset() + ") | " + 
-               ColorManager::getDateColor() + info.lastModified + ColorManager::getReset() + " | " + 
-               ColorManager::getPermissionsColor() + info.permissions + ColorManager::getReset();
+        treeLines_.push_back(line);
+    }
+}
+
+bool TreeBuilder::listDirectory(const fs::path& path, bool showHidden, 
+                                std::vector<DirEntry>& entries) {
+    SkippedCounts skipped;
+    bool listed = readDirectoryEntries(path, showHidden, entries, skipped);
+    hiddenObjectsCount_ += skipped.hidden;
+    ignoredObjectsCount_ += skipped.ignored;
+    return listed;
+}
+
+bool TreeBuilder::readDirectoryEntries(const fs::path& path, bool showHidden, 
+                                       std::vector<DirEntry>& entries, SkippedCounts& skipped) {
+    std::vector<DirectoryReader::Entry> rawEntries;
+    if (!FileSystem::readDirectory(path, rawEntries)) {
+        return false;
+    }
+    
+    const IgnoreRules::Scope* ignore = ignoreRules_ ? ignoreRules_->scopeFor(path, rawEntries) : nullptr;
+    
+    entries.reserve(rawEntries.size());
+    const std::string& base = path.native();
+    for (auto& raw : rawEntries) {
+        if (raw.name[0] == '.' && !showHidden) {
+            skipped.hidden++;
+            continue;
+        }
+        
+        DirEntry item;
+        // Как path / name, но строка пути выделяется один раз нужного размера
+        std::string full;
+        full.reserve(base.size() + 1 + raw.name.size());
+        full += base;
+        if (!full.empty() && full.back() != '/') {
+            full += '/';
+        }
+        full += raw.name;
+        item.path = fs::path(std::move(full));
+        item.name = std::move(raw.name);
+        item.isDirectory = raw.type == DirectoryReader::EntryType::DIRECTORY;
+        bool resolved = raw.type != DirectoryReader::EntryType::SYMLINK &&
+                        raw.type != DirectoryReader::EntryType::UNKNOWN;
+        
+        if (ignore) {
+            // Как и git, правила смотрят на саму запись: симлинк на директорию
+            // под "build/" не попадает. Тип без d_type - по lstat
+            bool directory = item.isDirectory;
+            if (raw.type == DirectoryReader::EntryType::UNKNOWN) {
+                FileSystem::RawMetadata meta;
+                if (FileSystem::readMetadata(item.path, meta, false)) {
+                    directory = S_ISDIR(meta.mode);
+                    resolved = !S_ISLNK(meta.mode);
+                    item.isDirectory = directory;
+                }
+            }
+            if (IgnoreRules::isIgnored(*ignore, item.path, item.name, directory)) {
+                skipped.ignored++;
+                continue;
+            }
+        }
+        
+        // Тип известен из d_type; stat нужен только симлинкам (каталог ли цель)
+        // и файловым системам, не заполняющим d_type
+        if (!resolved) {
+            FileSystem::RawMetadata meta;
+            item.isDirectory = FileSystem::readMetadata(item.path, meta, true) && S_ISDIR(meta.mode);
+        }
+        entries.push_back(std::move(item));
     }
+    return true;
+}
+
+void TreeBuilder::sortEntries(std::vector<DirEntry>& entries) {
+    Profiler::Scope scope(Profiler::Phase::SORT);
+    
+    // Сортировка: сначала директории, потом файлы
+    std::sort(entries.begin(), entries.end(), [](const DirEntry& a, const DirEntry& b) {
+        if (a.isDirectory != b.isDirectory) {
+            return a.isDirectory > b.isDirectory;
+        }
+        return a.name < b.name;
+    });
 }
 
 void TreeBuilder::printTree() const {
@@ -117,6 +211,7 @@ TreeBuilder::Statistics TreeBuilder::getStatistics() const {
 TreeBuilder::DisplayStatistics TreeBuilder::getDisplayStatistics() const {
     DisplayStatistics result = displayStats_;
     result.hiddenObjects = hiddenObjectsCount_;
+    result.ignoredObjects = ignoredObjectsCount_;
     return result;
 }
 
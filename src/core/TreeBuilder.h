@@ -5,6 +5,11 @@
 #include <chrono>
 #include "FileSystem.h"
 #include "ColorManager.h"
+#include "OutputSink.h"
+#include "Profiler.h"
+#include "LineRenderer.h"
+#include "IgnoreRules.h"
+#include <memory>
 
 class TreeBuilder {
 public:
@@ -20,12 +25,15 @@ public:
         uint64_t displayedSize = 0;
         size_t hiddenByDepth = 0;
         size_t hiddenObjects = 0;
+        // Пропущенные по .gitignore (--gitignore), отдельно от скрытых
+        size_t ignoredObjects = 0;
         int apiRequests = 0; 
         uint64_t buildTimeMicroseconds = 0;
+        uint64_t metadataSyscalls = 0;
 
         DisplayStatistics() : Statistics(), displayedFiles(0), displayedDirectories(0), 
-                         displayedSize(0), hiddenByDepth(0), hiddenObjects(0), apiRequests(0),
-                         buildTimeMicroseconds(0) {}
+                         displayedSize(0), hiddenByDepth(0), hiddenObjects(0), ignoredObjects(0), apiRequests(0),
+                         buildTimeMicroseconds(0), metadataSyscalls(0) {}
     };
     
     explicit TreeBuilder(const std::string& rootPath);
@@ -36,21 +44,84 @@ public:
     virtual Statistics getStatistics() const;
     virtual DisplayStatistics getDisplayStatistics() const;
     virtual const std::vector<std::string>& getTreeLines() const;
+    
+    // Строки пишутся в sink сразу во время обхода; без sink (nullptr)
+    // они накапливаются в памяти и доступны через getTreeLines()
+    void setOutputSink(OutputSink* sink) { sink_ = sink; }
+    // Правила .gitignore для всех обходов (--gitignore); nullptr - выключены.
+    // Задаются до построения дерева, как и FileSystem::setProvider
+    static void setIgnoreRules(std::shared_ptr<IgnoreRules> rules) { ignoreRules_ = std::move(rules); }
     virtual uint64_t getBuildTimeMicroseconds() const { return displayStats_.buildTimeMicroseconds; } 
     
 protected:
+    // Элементы, отброшенные при чтении каталога
+    struct SkippedCounts {
+        size_t hidden = 0;   // имя с точки без -a
+        size_t ignored = 0;  // правила .gitignore/.ignore
+    };
+    
+    // Элемент каталога: тип берется из directory_entry (d_type) один раз,
+    // чтобы сортировка не обращалась к файловой системе
+    struct DirEntry {
+        std::filesystem::path path;
+        std::string name;
+        bool isDirectory = false;
+    };
+    
+    // Метаданные файлов отсортированного каталога, запрашиваемые пачками:
+    // при доступном io_uring stat всей пачки уходят одним системным вызовом.
+    // Файлы идут после директорий, поэтому пачка - подряд идущие записи.
+    // Строки не форматируются: строка дерева собирается из сырых значений.
+    class MetadataBatch {
+    public:
+        static constexpr size_t BATCH_SIZE = 256;
+        
+        explicit MetadataBatch(const std::vector<DirEntry>& entries) : entries_(entries) {}
+        // Метаданные entries[index] (для симлинка - цели); ссылка живет до следующего вызова
+        const FileSystem::RawMetadata& at(size_t index);
+        // Только после at(index): пачка читается в at
+        bool isSymlink(size_t index) const { return symlinks_[index - first_] != 0; }
+        
+    private:
+        const std::vector<DirEntry>& entries_;
+        std::vector<const std::filesystem::path*> paths_;
+        std::vector<FileSystem::RawMetadata> metas_;
+        std::vector<char> symlinks_;
+        size_t first_ = 0;
+    };
+    
     std::filesystem::path rootPath_;
     Statistics stats_;
     DisplayStatistics displayStats_;
     std::vector<std::string> treeLines_;
+    OutputSink* sink_ = nullptr;
     size_t hiddenObjectsCount_ = 0;
+    size_t ignoredObjectsCount_ = 0;
+    // Буфер строки и стек отступов последовательного обхода
+    LineRenderer renderer_;
+    static std::shared_ptr<IgnoreRules> ignoreRules_;
+    
+    // Возвращает суммарный размер поддерева: размер директории
+    // накапливается за один проход обхода, без повторного сканирования.
+    // Отступ текущего уровня хранится в renderer_.
+    virtual uint64_t traverseDirectory(const std::filesystem::path& path, 
+                                     bool isLast,
+                                     bool showHidden,
+                                     bool isRoot = false);
+    
+    // Строка элемента в renderer_: отступ, соединитель и описание
+    void renderEntryLine(const FileSystem::FileInfo& info, bool isLast);
+    void renderEntryLine(std::string_view name, const FileSystem::RawMetadata& meta, bool isSymlink, bool isLast);
+    // Строка директории обхода по ее пути
+    void renderDirectoryLine(const std::filesystem::path& path, bool isLast);
     
-    virtual void traverseDirectory(const std::filesystem::path& path, 
-                                 const std::string& prefix, 
-                                 bool isLast,
-                                 bool showHidden,
-                                 bool isRoot = false);
+    void emitLine(const std::string& line);
     
-    virtual std::string formatTreeLine(const FileSystem::FileInfo& info, 
-                                     const std::string& connector) const;
+    bool listDirectory(const std::filesystem::path& path, bool showHidden, 
+                       std::vector<DirEntry>& entries);
+    // Потокобезопасный вариант: счетчики отброшенных элементов возвращаются вызывающему.
+    // Игнорируемые по --gitignore отбрасываются до stat
+    static bool readDirectoryEntries(const std::filesystem::path& path, bool showHidden, 
+                                     std::vector<DirEntry>& entries, SkippedCounts& skipped);
+    static void sortEntries(std::vector<DirEntry>& entries);
 };
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "TreeModel.h"
+#include <stdexcept>
+#include <sys/stat.h>
+
+void TreeModel::clear() {
+    names_.clear();
+    nameOffset_.assign(1, 0);
+    parent_.clear();
+    firstChild_.clear();
+    childCount_.clear();
+    size_.clear();
+    mtimeNs_.clear();
+    mode_.clear();
+    flags_.clear();
+}
+
+void TreeModel::reserve(size_t nodes, size_t nameBytes) {
+    names_.reserve(nameBytes);
+    nameOffset_.reserve(nodes + 1);
+    parent_.reserve(nodes);
+    firstChild_.reserve(nodes);
+    childCount_.reserve(nodes);
+    size_.reserve(nodes);
+    mtimeNs_.reserve(nodes);
+    mode_.reserve(nodes);
+    flags_.reserve(nodes);
+}
+
+TreeModel::Index TreeModel::addRoot(std::string_view name) {
+    clear();
+    return append(NONE, name, 0, 0, 0, DIRECTORY);
+}
+
+TreeModel::Index TreeModel::addChild(Index parent, std::string_view name, const FileSystem::RawMetadata& meta,
+                                     bool isDirectory, bool isSymlink) {
+    uint8_t flags = (isDirectory ? DIRECTORY : 0) | (isSymlink ? SYMLINK : 0);
+    // Размер директории появится после обхода ее поддерева
+    uint64_t size = isDirectory || S_ISDIR(meta.mode) ? 0 : meta.size;
+    Index node = append(parent, name, size, meta.mtimeNs, meta.mode, flags);
+    if (childCount_[parent]++ == 0) {
+        firstChild_[parent] = node;
+    }
+    return node;
+}
+
+TreeModel::Index TreeModel::append(Index parent, std::string_view name, uint64_t size, int64_t mtimeNs,
+                                   uint32_t mode, uint8_t flags) {
+    if (parent_.size() >= NONE) {
+        throw std::length_error("слишком много элементов для модели дерева");
+    }
+    names_ += name;
+    nameOffset_.push_back(names_.size());
+    parent_.push_back(parent);
+    firstChild_.push_back(NONE);
+    childCount_.push_back(0);
+    size_.push_back(size);
+    mtimeNs_.push_back(mtimeNs);
+    mode_.push_back(mode);
+    flags_.push_back(flags);
+    return static_cast<Index>(parent_.size() - 1);
+}
+
+void TreeModel::accumulateSizes() {
+    for (Index node = 0; node < size(); ++node) {
+        if (isDirectory(node)) {
+            size_[node] = 0;
+        }
+    }
+    for (Index node = static_cast<Index>(size()); node-- > 1;) {
+        size_[parent_[node]] += size_[node];
+    }
+}
+
+bool TreeModel::assign(std::string names, std::vector<uint64_t> nameOffsets, std::vector<Index> parents,
+                       std::vector<uint64_t> sizes, std::vector<int64_t> mtimesNs,
+                       std::vector<uint32_t> modes, std::vector<uint8_t> flags) {
+    clear();
+    size_t count = parents.size();
+    bool ok = count > 0 && count < NONE && nameOffsets.size() == count + 1 &&
+              sizes.size() == count && mtimesNs.size() == count &&
+              modes.size() == count && flags.size() == count &&
+              nameOffsets.front() == 0 && nameOffsets.back() == names.size() && parents[ROOT] == NONE;
+
+    std::vector<Index> firstChild(ok ? count : 0, NONE);
+    std::vector<Index> childCount(ok ? count : 0, 0);
+    for (Index node = 0; ok && node < count; ++node) {
+        ok = nameOffsets[node] <= nameOffsets[node + 1] && (flags[node] & ~FLAG_MASK) == 0;
+        if (!ok || node == ROOT) {
+            continue;
+        }
+        Index parent = parents[node];
+        ok = parent < node;
+        if (ok && childCount[parent]++ == 0) {
+            firstChild[parent] = node;
+        } else if (ok) {
+            // Дети узла - одним блоком
+            ok = firstChild[parent] + childCount[parent] - 1 == node;
+        }
+    }
+    if (!ok) {
+        return false;
+    }
+
+    names_ = std::move(names);
+    nameOffset_ = std::move(nameOffsets);
+    parent_ = std::move(parents);
+    firstChild_ = std::move(firstChild);
+    childCount_ = std::move(childCount);
+    size_ = std::move(sizes);
+    mtimeNs_ = std::move(mtimesNs);
+    mode_ = std::move(modes);
+    flags_ = std::move(flags);
+    return true;
+}
+
+FileSystem::RawMetadata TreeModel::metadata(Index node) const {
+    FileSystem::RawMetadata meta;
+    meta.mode = mode_[node];
+    meta.size = size_[node];
+    meta.mtimeNs = mtimeNs_[node];
+    return meta;
+}
+
+FileSystem::FileInfo TreeModel::entryInfo(Index node) const {
+    return FileSystem::makeFileInfo(std::string(name(node)), metadata(node), isSymlink(node));
+}
+
+size_t TreeModel::memoryUsage() const {
+    return names_.capacity() +
+           nameOffset_.capacity() * sizeof(uint64_t) +
+           (parent_.capacity() + firstChild_.capacity() + childCount_.capacity()) * sizeof(Index) +
+           size_.capacity() * sizeof(uint64_t) +
+           mtimeNs_.capacity() * sizeof(int64_t) +
+           mode_.capacity() * sizeof(uint32_t) +
+           flags_.capacity();
+}
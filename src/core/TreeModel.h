@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "FileSystem.h"
+
+// Дерево в памяти в виде параллельных массивов (struct of arrays).
+// Имена лежат подряд в одном пуле, у узла - индексы родителя и первого
+// ребенка, дети одного узла идут подряд в порядке вывода. Хранятся только
+// сырые размер, mtime и режим: строки форматируются при выводе.
+// Узел занимает около 40 байт плюс имя вместо сотен байт у FileInfo.
+class TreeModel {
+public:
+    using Index = uint32_t;
+    static constexpr Index NONE = UINT32_MAX;
+    static constexpr Index ROOT = 0;
+
+    enum Flag : uint8_t { DIRECTORY = 1, SYMLINK = 2, UNREADABLE = 4 };
+    static constexpr uint8_t FLAG_MASK = DIRECTORY | SYMLINK | UNREADABLE;
+
+    void clear();
+    void reserve(size_t nodes, size_t nameBytes);
+
+    // Корень: name - путь, как его передал пользователь
+    Index addRoot(std::string_view name);
+    // Добавляет ребенка parent. Все дети узла добавляются подряд, без
+    // вклинивания детей других узлов (листинг каталога - один блок).
+    // Модель не потокобезопасна: параллельный обход добавляет блоки под mutex.
+    Index addChild(Index parent, std::string_view name, const FileSystem::RawMetadata& meta,
+                   bool isDirectory, bool isSymlink);
+    // Каталог не удалось прочитать: детей нет
+    void markUnreadable(Index node) { flags_[node] |= UNREADABLE; }
+    // Размер поддерева директории, известный после обхода ее детей
+    void setSize(Index node, uint64_t size) { size_[node] = size; }
+    // Размеры всех директорий как суммы поддеревьев - для модели, заполненной
+    // без setSize (параллельным обходом). Ребенок всегда добавлен после родителя.
+    void accumulateSizes();
+    // Модель из готовых столбцов (чтение TreeArchive): первый узел - корень,
+    // родитель идет раньше детей, дети одного узла - подряд. Индексы детей
+    // восстанавливаются по родителям; при нарушении - false и пустая модель.
+    bool assign(std::string names, std::vector<uint64_t> nameOffsets, std::vector<Index> parents,
+                std::vector<uint64_t> sizes, std::vector<int64_t> mtimesNs,
+                std::vector<uint32_t> modes, std::vector<uint8_t> flags);
+
+    size_t size() const { return parent_.size(); }
+    bool empty() const { return parent_.empty(); }
+
+    std::string_view name(Index node) const {
+        return std::string_view(names_).substr(nameOffset_[node], nameOffset_[node + 1] - nameOffset_[node]);
+    }
+    Index parent(Index node) const { return parent_[node]; }
+    Index firstChild(Index node) const { return firstChild_[node]; }
+    Index childCount(Index node) const { return childCount_[node]; }
+    // Для директории - суммарный размер поддерева
+    uint64_t fileSize(Index node) const { return size_[node]; }
+    int64_t mtimeNs(Index node) const { return mtimeNs_[node]; }
+    uint32_t mode(Index node) const { return mode_[node]; }
+    // Обходится как директория (в том числе симлинк на директорию)
+    bool isDirectory(Index node) const { return (flags_[node] & DIRECTORY) != 0; }
+    bool isSymlink(Index node) const { return (flags_[node] & SYMLINK) != 0; }
+    bool isUnreadable(Index node) const { return (flags_[node] & UNREADABLE) != 0; }
+    uint8_t flags(Index node) const { return flags_[node]; }
+
+    // Размер (для директории - поддерева), mtime и режим узла
+    FileSystem::RawMetadata metadata(Index node) const;
+    // Отформатированная информация об узле для JSON; текст дерева
+    // собирается из metadata без промежуточных строк
+    FileSystem::FileInfo entryInfo(Index node) const;
+
+    // Байт, занятых массивами и пулом имен
+    size_t memoryUsage() const;
+
+private:
+    std::string names_;
+    // На один элемент больше узлов: имя узла i - [nameOffset_[i], nameOffset_[i + 1])
+    std::vector<uint64_t> nameOffset_{0};
+    std::vector<Index> parent_;
+    std::vector<Index> firstChild_;
+    std::vector<Index> childCount_;
+    std::vector<uint64_t> size_;
+    std::vector<int64_t> mtimeNs_;
+    std::vector<uint32_t> mode_;
+    std::vector<uint8_t> flags_;
+
+    Index append(Index parent, std::string_view name, uint64_t size, int64_t mtimeNs, uint32_t mode, uint8_t flags);
+};
@@ -0,0 +1,48 @@
+#include "TreeTextRenderer.h"
+#include "ColorManager.h"
+
+void TreeTextRenderer::render(const TreeModel& model, const TreeView& view, OutputSink& sink) {
+    if (model.empty()) {
+        return;
+    }
+    LineRenderer renderer;
+    sink.writeLine(ColorManager::getDirNameColor() + "[DIR]" + ColorManager::getReset());
+    renderChildren(model, view, TreeModel::ROOT, true, renderer, sink);
+}
+
+void TreeTextRenderer::renderChildren(const TreeModel& model, const TreeView& view, TreeModel::Index node,
+                                      bool isLast, LineRenderer& renderer, OutputSink& sink) {
+    TreeModel::Index first = model.firstChild(node);
+    TreeModel::Index end = first + model.childCount(node);
+    TreeModel::Index last = end;
+    for (TreeModel::Index child = end; child-- > first;) {
+        if (view.state(child) != TreeView::State::HIDDEN) {
+            last = child;
+            break;
+        }
+    }
+
+    renderer.pushLevel(isLast);
+    for (TreeModel::Index child = first; child < end; ++child) {
+        TreeView::State state = view.state(child);
+        if (state == TreeView::State::HIDDEN || state == TreeView::State::PLACEHOLDER) {
+            continue;
+        }
+
+        bool entryIsLast = child == last;
+        renderer.beginLine(entryIsLast);
+        renderer.appendEntry(model.name(child), model.metadata(child), model.isSymlink(child));
+        if (state == TreeView::State::CUT) {
+            renderer.append(" ");
+            renderer.append(ColorManager::getHiddenContentColor());
+            renderer.append("(содержимое скрыто)");
+            renderer.append(ColorManager::getReset());
+        }
+        sink.writeLine(renderer.line());
+
+        if (state == TreeView::State::SHOWN && model.isDirectory(child)) {
+            renderChildren(model, view, child, entryIsLast, renderer, sink);
+        }
+    }
+    renderer.popLevel();
+}
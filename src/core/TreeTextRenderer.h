@@ -0,0 +1,16 @@
+#pragma once
+#include "LineRenderer.h"
+#include "OutputSink.h"
+#include "TreeModel.h"
+#include "TreeView.h"
+
+// Текстовое дерево по модели и виду: те же строки, что выводят построители
+// при обходе. Общий вывод для ModelTreeBuilder и загруженного TreeArchive.
+class TreeTextRenderer {
+public:
+    static void render(const TreeModel& model, const TreeView& view, OutputSink& sink);
+
+private:
+    static void renderChildren(const TreeModel& model, const TreeView& view, TreeModel::Index node,
+                               bool isLast, LineRenderer& renderer, OutputSink& sink);
+};
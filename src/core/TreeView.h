@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "TreeModel.h"
+
+// Что из модели попадает в вывод: решение фильтров и ограничения глубины
+// для каждого узла. Считается один раз и используется всеми форматами вывода.
+// Пустой вид показывает дерево целиком.
+struct TreeView {
+    enum class State : uint8_t {
+        SHOWN,          // строка выводится, директория раскрывается
+        CUT,            // директория выводится без содержимого (граница глубины)
+        PLACEHOLDER,    // строки нет, но место среди соседей занято
+        HIDDEN          // элемента нет в выводе
+    };
+
+    std::vector<State> states;
+
+    State state(TreeModel::Index node) const {
+        return states.empty() ? State::SHOWN : states[node];
+    }
+};
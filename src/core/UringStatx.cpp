@@ -0,0 +1,242 @@
+#include "UringStatx.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define TREE_UTILITY_HAS_IO_URING 1
+#endif
+#endif
+
+#ifdef TREE_UTILITY_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+namespace {
+    const unsigned STATX_FIELDS = STATX_TYPE | STATX_MODE | STATX_SIZE |
+                                  STATX_MTIME | STATX_INO | STATX_NLINK;
+
+    int ioUringSetup(unsigned entries, io_uring_params* params) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                                        IORING_ENTER_GETEVENTS, nullptr, 0));
+    }
+
+    template <typename T>
+    T* at(void* base, unsigned offset) {
+        return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+    }
+}
+
+UringStatx::UringStatx(unsigned queueDepth) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ringFd_ = ioUringSetup(queueDepth, &params);
+    if (ringFd_ < 0) {
+        ringFd_ = -1;
+        return;
+    }
+    queueDepth_ = params.sq_entries;
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    // Ядра 5.4+ отображают обе очереди одним mmap
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ == MAP_FAILED) {
+        sqRing_ = nullptr;
+        close();
+        return;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            cqRing_ = nullptr;
+            close();
+            return;
+        }
+    }
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                 ringFd_, IORING_OFF_SQES);
+    if (sqes_ == MAP_FAILED) {
+        sqes_ = nullptr;
+        close();
+        return;
+    }
+
+    sqTail_ = at<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = *at<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqArray_ = at<unsigned>(sqRing_, params.sq_off.array);
+    cqHead_ = at<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = at<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = *at<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = at<void>(cqRing_, params.cq_off.cqes);
+}
+
+UringStatx::~UringStatx() {
+    close();
+}
+
+void UringStatx::close() {
+    if (sqes_) {
+        munmap(sqes_, sqesSize_);
+    }
+    if (cqRing_ && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    if (sqRing_) {
+        munmap(sqRing_, sqRingSize_);
+    }
+    sqes_ = sqRing_ = cqRing_ = nullptr;
+    if (ringFd_ >= 0) {
+        ::close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
+bool UringStatx::statBatch(const std::vector<const fs::path*>& paths,
+                           std::vector<FileSystem::RawMetadata>& metas,
+                           uint64_t& syscalls) {
+    if (ringFd_ < 0) {
+        return false;
+    }
+    metas.assign(paths.size(), FileSystem::RawMetadata{});
+    static_assert(sizeof(StatxBuffer) >= sizeof(struct statx), "StatxBuffer меньше struct statx");
+    // Буферы - член кольца: ядро пишет в них, пока запрос не завершен
+    buffers_.resize(queueDepth_);
+    auto* buffers = static_cast<struct statx*>(static_cast<void*>(buffers_.data()));
+    auto* sqes = static_cast<io_uring_sqe*>(sqes_);
+    auto* cqes = static_cast<io_uring_cqe*>(cqes_);
+
+    for (size_t first = 0; first < paths.size(); first += queueDepth_) {
+        unsigned count = static_cast<unsigned>(std::min<size_t>(queueDepth_, paths.size() - first));
+
+        // Хвост очереди отправки пишет только этот поток
+        unsigned tail = *sqTail_;
+        for (unsigned k = 0; k < count; ++k) {
+            unsigned index = tail & sqMask_;
+            io_uring_sqe& sqe = sqes[index];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_STATX;
+            sqe.fd = AT_FDCWD;
+            sqe.addr = reinterpret_cast<uint64_t>(paths[first + k]->c_str());
+            sqe.len = STATX_FIELDS;
+            sqe.off = reinterpret_cast<uint64_t>(&buffers[k]);
+            sqe.statx_flags = AT_SYMLINK_NOFOLLOW;
+            sqe.user_data = k;
+            sqArray_[index] = index;
+            ++tail;
+        }
+        __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+
+        unsigned toSubmit = count;
+        unsigned completed = 0;
+        bool unsupported = false;
+        while (completed < count) {
+            syscalls++;
+            int rc = ioUringEnter(ringFd_, toSubmit, count - completed);
+            if (rc < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // Кольцом больше не пользуемся, но отправленные запросы еще
+                // пишут в buffers_ - сначала дожидаемся их завершения
+                if (!drain(count - toSubmit - completed)) {
+                    abandon();
+                    return false;
+                }
+                close();
+                return false;
+            }
+            toSubmit -= std::min<unsigned>(toSubmit, static_cast<unsigned>(rc));
+
+            unsigned head = *cqHead_;
+            unsigned cqTail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+            for (; head != cqTail; ++head) {
+                const io_uring_cqe& cqe = cqes[head & cqMask_];
+                size_t k = static_cast<size_t>(cqe.user_data);
+                if (cqe.res == 0) {
+                    const struct statx& stx = buffers[k];
+                    FileSystem::RawMetadata& meta = metas[first + k];
+                    meta.mode = stx.stx_mode;
+                    meta.size = stx.stx_size;
+                    meta.mtimeNs = static_cast<int64_t>(stx.stx_mtime.tv_sec) * 1000000000LL + stx.stx_mtime.tv_nsec;
+                    meta.inode = stx.stx_ino;
+                    meta.nlink = stx.stx_nlink;
+                } else if (cqe.res == -EINVAL || cqe.res == -EOPNOTSUPP) {
+                    // Ядро 5.1-5.5: кольцо есть, а операции statx нет
+                    unsupported = true;
+                }
+                completed++;
+            }
+            __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        }
+        if (unsupported) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool UringStatx::drain(unsigned inFlight) {
+    while (inFlight > 0) {
+        int rc = ioUringEnter(ringFd_, 0, inFlight);
+        if (rc < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            return false;
+        }
+        unsigned head = *cqHead_;
+        unsigned cqTail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        unsigned reaped = std::min(cqTail - head, inFlight);
+        inFlight -= reaped;
+        __atomic_store_n(cqHead_, head + reaped, __ATOMIC_RELEASE);
+    }
+    return true;
+}
+
+void UringStatx::abandon() {
+    // Дождаться запросов не удалось: буферы и кольцо намеренно не освобождаются,
+    // чтобы ядро не записало результат в чужую память
+    new std::vector<StatxBuffer>(std::move(buffers_));
+    buffers_.clear();
+    ringFd_ = -1;
+    sqes_ = sqRing_ = cqRing_ = nullptr;
+}
+
+#else
+
+UringStatx::UringStatx(unsigned) {}
+
+UringStatx::~UringStatx() {}
+
+void UringStatx::close() {}
+
+bool UringStatx::drain(unsigned) {
+    return true;
+}
+
+void UringStatx::abandon() {}
+
+bool UringStatx::statBatch(const std::vector<const fs::path*>&,
+                           std::vector<FileSystem::RawMetadata>&,
+                           uint64_t&) {
+    return false;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "FileSystem.h"
+
+// Пакетный statx через io_uring (Linux 5.6+). liburing не нужен: кольца
+// создаются io_uring_setup и отображаются через mmap напрямую.
+// Кольцо не потокобезопасно - у каждого потока обхода свое.
+class UringStatx {
+public:
+    explicit UringStatx(unsigned queueDepth);
+    ~UringStatx();
+    UringStatx(const UringStatx&) = delete;
+    UringStatx& operator=(const UringStatx&) = delete;
+
+    // Кольцо создано; иначе ядро io_uring не дает (нет, запрещен seccomp/sysctl)
+    bool isOpen() const { return ringFd_ >= 0; }
+    unsigned getQueueDepth() const { return queueDepth_; }
+
+    // lstat всех путей окнами по глубине очереди, metas[i] - для paths[i];
+    // meta.mode == 0 - путь не прочитан. false - ядро не поддерживает
+    // IORING_OP_STATX или кольцо сломалось: результаты не заполнены.
+    // syscalls увеличивается на число вызовов io_uring_enter.
+    bool statBatch(const std::vector<const fs::path*>& paths,
+                   std::vector<FileSystem::RawMetadata>& metas,
+                   uint64_t& syscalls);
+
+private:
+    int ringFd_ = -1;
+    unsigned queueDepth_ = 0;
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    void* sqes_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+
+    unsigned* sqTail_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    void* cqes_ = nullptr;
+
+    // Место под struct statx без <linux/stat.h> в заголовке
+    struct alignas(8) StatxBuffer {
+        unsigned char bytes[256];
+    };
+    std::vector<StatxBuffer> buffers_;
+
+    void close();
+    // Ждет inFlight отправленных запросов; false - ядро не дало дождаться
+    bool drain(unsigned inFlight);
+    // Оставляет кольцо и буферы ядру навсегда (если drain не удался)
+    void abandon();
+};
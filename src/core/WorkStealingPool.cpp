@@ -0,0 +1,138 @@
+#include "WorkStealingPool.h"
+#include "Profiler.h"
+
+namespace {
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local int currentIndex = -1;
+}
+
+WorkStealingPool::WorkStealingPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    
+    queues_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    
+    threads_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+int WorkStealingPool::currentWorkerIndex() const {
+    return currentPool == this ? currentIndex : -1;
+}
+
+void WorkStealingPool::submit(Task task) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    
+    // Рабочий кладет задачу себе, внешний поток распределяет по кругу
+    int self = currentWorkerIndex();
+    size_t index = self >= 0 ? static_cast<size_t>(self) 
+                             : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+        queued_.fetch_add(1, std::memory_order_seq_cst);
+    }
+    
+    // Пара seq_cst-операций с рабочим (queued_ здесь, sleepers_ у него):
+    // либо рабочий увидит новую задачу до сна, либо здесь виден он сам.
+    // Захват sleepMutex_ нужен, только если кто-то собирается спать
+    if (sleepers_.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    allDone_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+}
+
+bool WorkStealingPool::popLocal(size_t index, Task& task) {
+    auto& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thief, Task& task) {
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        auto& queue = *queues_[(thief + offset) % queues_.size()];
+        // Очереди держатся под замком считанные инструкции, поэтому
+        // ожидание замка дешевле повторного обхода и не теряет задачи
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::finishTask() {
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        allDone_.notify_all();
+    }
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = static_cast<int>(index);
+    Profiler::setThreadName("worker " + std::to_string(index));
+    
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            task();
+            task = nullptr;
+            finishTask();
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        if (stop_) {
+            return;
+        }
+        // queued_ меняется под замком очереди, так что при queued_ > 0
+        // задача действительно лежит в одной из очередей
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        workAvailable_.wait(lock, [this] {
+            return stop_ || queued_.load(std::memory_order_seq_cst) > 0;
+        });
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        if (stop_ && queued_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
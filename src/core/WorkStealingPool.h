@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул потоков с очередью на каждого рабочего. Задачи, порожденные рабочим,
+// кладутся в его собственную очередь (LIFO), свободные рабочие забирают
+// задачи с противоположного конца чужих очередей.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+    
+    explicit WorkStealingPool(size_t threadCount);
+    ~WorkStealingPool();
+    
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    
+    void submit(Task task);
+    // Ждет завершения всех задач, включая порожденные во время ожидания
+    void wait();
+    
+    size_t threadCount() const { return threads_.size(); }
+    // Индекс рабочего этого пула в текущем потоке, -1 для внешних потоков
+    int currentWorkerIndex() const;
+    
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+    // Задачи, лежащие в очередях; меняется под замком очереди
+    std::atomic<size_t> queued_{0};
+    // Рабочие, готовые уснуть; пока их нет, submit не трогает sleepMutex_
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> nextQueue_{0};
+    std::atomic<bool> stop_{false};
+    std::mutex sleepMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t thief, Task& task);
+    void finishTask();
+};
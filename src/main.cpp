@@ -3,6 +3,10 @@
 #include "CommandLineParser.h"
 #include "BuilderFactory.h"
 #include "OutputManager.h"
+#include "FileColorTable.h"
+#include "FileSystem.h"
+#include "SyntheticFileSystem.h"
+#include "ScanIndex.h"
 
 int main(int argc, char* argv[]) {
     CommandLineOptions options;
@@ -21,13 +25,35 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Пользовательская схема цветов применяется один раз, до обхода
+    FileColorTable::loadFromEnvironment();
+    
+    PosixFileSystemProvider::setQueueDepth(options.uringDepth);
+    std::shared_ptr<FileSystemProvider> provider = std::make_shared<PosixFileSystemProvider>();
+    if (!options.syntheticSpec.empty()) {
+        SyntheticFileSystem::Spec spec;
+        if (!SyntheticFileSystem::parseSpec(options.syntheticSpec, spec)) {
+            return 1;
+        }
+        provider = std::make_shared<SyntheticFileSystem>(spec, options.path);
+    }
+    
+    std::shared_ptr<ScanIndex> index;
+    if (!options.indexPath.empty() && !options.isGitHub) {
+        index = std::make_shared<ScanIndex>(provider, options.indexPath);
+        index->load();
+        provider = index;
+    }
+    FileSystem::setProvider(provider);
+    if (options.gitignore) {
+        TreeBuilder::setIgnoreRules(std::make_shared<IgnoreRules>(options.path));
+    }
+    
     builder = BuilderFactory::create(options);
     
     CommandLineParser::applyFilters(options, *builder);
 
     try {
-        builder->buildTree(options.showHidden);
-        
         if (!options.outputFile.empty()) {
             if (!OutputManager::outputToFile(options.outputFile, *builder, options)) {
                 return 1;
@@ -36,10 +62,31 @@ int main(int argc, char* argv[]) {
             OutputManager::outputToConsole(*builder, options);
         }
         
+        if (!options.jsonOutputFile.empty() && !OutputManager::saveJSON(options.jsonOutputFile, *builder, options)) {
+            return 1;
+        }
+        
+        if (options.watch) {
+            auto watchBuilder = dynamic_cast<WatchTreeBuilder*>(builder.get());
+            if (!watchBuilder || !OutputManager::watchConsole(*watchBuilder, options)) {
+                return 1;
+            }
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "Ошибка: " << e.what() << std::endl;
         return 1;
     }
     
+    if (index) {
+        if (options.profile) {
+            std::cerr << "Индекс: директорий из индекса " << index->getHitCount()
+                      << ", прочитано заново " << index->getMissCount() << std::endl;
+        }
+        if (!index->save()) {
+            return 1;
+        }
+    }
+    
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include "GlobMatcher.h"
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Patterns = std::vector<std::pair<std::string, bool>>;
+
+    GlobMatcher compile(const Patterns& patterns) {
+        GlobMatcher matcher;
+        for (const auto& [pattern, include] : patterns) {
+            matcher.add(pattern, include);
+        }
+        return matcher;
+    }
+
+    // Эталон: каждый шаблон отдельно через matchGlob, исключение сильнее включения
+    bool reference(const Patterns& patterns, std::string_view name) {
+        bool hasInclude = false;
+        bool included = false;
+        for (const auto& [pattern, include] : patterns) {
+            bool matched = GlobMatcher::matchGlob(pattern, name);
+            if (include) {
+                hasInclude = true;
+                included = included || matched;
+            } else if (matched) {
+                return false;
+            }
+        }
+        return !hasInclude || included;
+    }
+
+    void expectSameAsReference(const Patterns& patterns, const std::vector<std::string>& names) {
+        GlobMatcher matcher = compile(patterns);
+        for (const auto& name : names) {
+            EXPECT_EQ(matcher.matches(name), reference(patterns, name)) << "имя \"" << name << "\"";
+        }
+    }
+
+    struct GlobCase {
+        const char* pattern;
+        const char* name;
+        bool expected;
+    };
+}
+
+TEST(GlobMatcherTest, MatchGlobTable) {
+    const GlobCase cases[] = {
+        {"*", "", true},
+        {"*", "anything", true},
+        {"", "", true},
+        {"", "a", false},
+        {"?", "", false},
+        {"?", "a", true},
+        {"?", "ab", false},
+        {"*.cpp", "main.cpp", true},
+        {"*.cpp", ".cpp", true},
+        {"*.cpp", "main.cpp.bak", false},
+        {"test*", "test", true},
+        {"test*", "test_parser.cpp", true},
+        {"test*", "atest", false},
+        {"a*b", "ab", true},
+        {"a*b", "aXXb", true},
+        {"a*b", "aXXbc", false},
+        {"a*b*c", "abbbc", true},
+        {"a*b*c", "acb", false},
+        {"*a*", "bab", true},
+        {"?ain.*", "main.cpp", true},
+        {"?ain.*", "ain.cpp", false},
+        {"main.?pp", "main.hpp", true},
+        {"main.?pp", "main.pp", false},
+        {"*?", "", false},
+        {"*?", "x", true},
+        {"??*", "x", false},
+        {"**.h", "a.h", true},
+        {"MAIN.CPP", "main.cpp", true},
+        {"*.Cpp", "MAIN.cPP", true},
+        {"[a]", "[a]", true},
+        {"[a]", "a", false},
+    };
+    for (const auto& c : cases) {
+        EXPECT_EQ(GlobMatcher::matchGlob(c.pattern, c.name), c.expected)
+            << "шаблон \"" << c.pattern << "\", имя \"" << c.name << "\"";
+    }
+}
+
+TEST(GlobMatcherTest, EmptyMatcherAcceptsEverything) {
+    GlobMatcher matcher;
+    EXPECT_TRUE(matcher.empty());
+    EXPECT_TRUE(matcher.matches(""));
+    EXPECT_TRUE(matcher.matches("main.cpp"));
+}
+
+TEST(GlobMatcherTest, SingleCompiledPatternMatchesMatchGlob) {
+    // Каждый вид шаблона отдельно: имя целиком, хвост, начало и автомат
+    const GlobCase cases[] = {
+        {"Makefile", "Makefile", true}, {"Makefile", "makefile", true}, {"Makefile", "Makefile.am", false},
+        {"*.cpp", "a.CPP", true},       {"*.cpp", "cpp", false},        {"test*", "TEST_x", true},
+        {"test*", "tes", false},        {"*", "", true},                {"?", "", false},
+        {"*_test.*", "a_test.cpp", true}, {"*_test.*", "a_test", false}, {"a?c*", "abcdef", true},
+        {"*?.h", ".h", false},          {"*?.h", "a.h", true},          {"", "", true},
+    };
+    for (const auto& c : cases) {
+        GlobMatcher matcher;
+        matcher.add(c.pattern, true);
+        EXPECT_EQ(matcher.matches(c.name), c.expected) << "шаблон \"" << c.pattern << "\", имя \"" << c.name << "\"";
+        EXPECT_EQ(matcher.matches(c.name), GlobMatcher::matchGlob(c.pattern, c.name))
+            << "шаблон \"" << c.pattern << "\", имя \"" << c.name << "\"";
+    }
+}
+
+TEST(GlobMatcherTest, ExcludeWinsOverInclude) {
+    // Исключение срабатывает, из какого бы списка (хвост, начало, автомат) ни пришло включение
+    const Patterns patterns = {
+        {"*.cpp", true}, {"test*", true}, {"*_impl*", true},
+        {"*_test.cpp", false}, {"test_skip*", false}, {"*.o", false}, {"*_impl_old?", false},
+    };
+    GlobMatcher matcher = compile(patterns);
+    EXPECT_TRUE(matcher.matches("main.cpp"));
+    EXPECT_FALSE(matcher.matches("parser_test.cpp"));
+    EXPECT_TRUE(matcher.matches("test_parser.h"));
+    EXPECT_FALSE(matcher.matches("test_skip.h"));
+    EXPECT_TRUE(matcher.matches("tree_impl.h"));
+    EXPECT_FALSE(matcher.matches("tree_impl_old2"));
+    EXPECT_FALSE(matcher.matches("test.o"));
+    EXPECT_FALSE(matcher.matches("README"));
+    expectSameAsReference(patterns, {"main.cpp", "parser_test.cpp", "test_parser.h", "test_skip.h",
+                                     "tree_impl.h", "tree_impl_old2", "test.o", "README", "", "TEST_SKIP"});
+}
+
+TEST(GlobMatcherTest, OnlyExcludesAcceptTheRest) {
+    const Patterns patterns = {{"*.tmp", false}, {"?~", false}, {"core", false}};
+    GlobMatcher matcher = compile(patterns);
+    EXPECT_FALSE(matcher.matches("a.TMP"));
+    EXPECT_FALSE(matcher.matches("x~"));
+    EXPECT_TRUE(matcher.matches("xy~"));
+    EXPECT_FALSE(matcher.matches("Core"));
+    EXPECT_TRUE(matcher.matches("core.c"));
+    EXPECT_TRUE(matcher.matches(""));
+}
+
+TEST(GlobMatcherTest, EmptyNameAgainstEveryKind) {
+    // Пустое имя не доходит до списков хвостов и начал, решает только автомат
+    expectSameAsReference({{"*.cpp", true}}, {""});
+    expectSameAsReference({{"test*", true}}, {""});
+    expectSameAsReference({{"*", true}}, {""});
+    expectSameAsReference({{"", true}}, {""});
+    expectSameAsReference({{"*", true}, {"", false}}, {"", "a"});
+    expectSameAsReference({{"?*", true}}, {"", "a"});
+}
+
+TEST(GlobMatcherTest, CaseFoldingIsAsciiOnly) {
+    GlobMatcher matcher;
+    matcher.add("*.JPG", true);
+    matcher.add("Ab?d*", true);
+    EXPECT_TRUE(matcher.matches("photo.jpg"));
+    EXPECT_TRUE(matcher.matches("ABCD"));
+    EXPECT_TRUE(matcher.matches("abxdEFG"));
+    // Байты вне ASCII сравниваются как есть
+    GlobMatcher utf8;
+    utf8.add("\xD0\xB0*", true);  // "а" кириллицей
+    EXPECT_TRUE(utf8.matches("\xD0\xB0\xD0\xB1"));
+    EXPECT_FALSE(utf8.matches("\xD0\x90\xD0\xB1"));  // "А" - другой байт
+}
+
+TEST(GlobMatcherTest, PatternsShareAutomatonWords) {
+    // Двадцать шаблонов по несколько позиций занимают несколько 64-битных слов;
+    // шаблоны на стыке слов не должны влиять друг на друга
+    Patterns patterns;
+    for (int i = 0; i < 20; ++i) {
+        std::string pattern = "?" + std::to_string(i) + "*x" + std::string(i % 5, '?');
+        patterns.emplace_back(pattern, i % 3 != 0);
+    }
+    std::vector<std::string> names;
+    for (int i = 0; i < 25; ++i) {
+        for (int tail = 0; tail < 6; ++tail) {
+            names.push_back("a" + std::to_string(i) + "mmx" + std::string(tail, 'z'));
+            names.push_back("a" + std::to_string(i) + "x" + std::string(tail, 'z'));
+        }
+    }
+    expectSameAsReference(patterns, names);
+}
+
+TEST(GlobMatcherTest, LongPatternsFallBackToMatchGlob) {
+    // 63 позиции еще помещаются в слово, 64 и больше - перебор
+    std::string fits = std::string(62, 'a') + "?";
+    std::string tooLong = std::string(63, 'a') + "?";
+    std::string tooLongWithStar = "*" + std::string(70, 'b') + "*";
+    Patterns patterns = {{fits, true}, {tooLong, true}, {tooLongWithStar, true}, {"*" + std::string(64, 'c'), false}};
+    std::vector<std::string> names = {
+        std::string(62, 'a') + "z",
+        std::string(63, 'a'),
+        std::string(63, 'a') + "z",
+        std::string(64, 'a') + "z",
+        std::string(63, 'A') + "Z",
+        "x" + std::string(70, 'b') + "y",
+        std::string(69, 'b'),
+        std::string(70, 'b') + std::string(64, 'c'),
+        "",
+    };
+    GlobMatcher matcher = compile(patterns);
+    EXPECT_TRUE(matcher.matches(std::string(62, 'a') + "z"));
+    EXPECT_TRUE(matcher.matches(std::string(63, 'A') + "Z"));
+    EXPECT_FALSE(matcher.matches(std::string(64, 'a') + "z"));
+    EXPECT_TRUE(matcher.matches("x" + std::string(70, 'b') + "y"));
+    EXPECT_FALSE(matcher.matches(std::string(70, 'b') + std::string(64, 'c')));
+    expectSameAsReference(patterns, names);
+}
+
+TEST(GlobMatcherTest, RandomPatternsMatchReference) {
+    // Короткий алфавит, чтобы совпадения были частыми
+    std::mt19937 rng(2024);
+    const char alphabet[] = {'a', 'b', 'A', '.', '*', '?'};
+    auto randomText = [&](size_t maxLength, size_t alphabetSize) {
+        std::string text(rng() % (maxLength + 1), ' ');
+        for (auto& c : text) {
+            c = alphabet[rng() % alphabetSize];
+        }
+        return text;
+    };
+    for (int round = 0; round < 300; ++round) {
+        Patterns patterns;
+        size_t count = 1 + rng() % 8;
+        for (size_t i = 0; i < count; ++i) {
+            patterns.emplace_back(randomText(6, 6), rng() % 3 != 0);
+        }
+        std::vector<std::string> names;
+        for (int i = 0; i < 40; ++i) {
+            names.push_back(randomText(8, 4));
+        }
+        expectSameAsReference(patterns, names);
+    }
+}
+
+TEST(GlobMatcherTest, ClearForgetsPatterns) {
+    GlobMatcher matcher;
+    matcher.add("*.cpp", true);
+    matcher.add("a?c", false);
+    EXPECT_FALSE(matcher.matches("main.h"));
+    matcher.clear();
+    EXPECT_TRUE(matcher.empty());
+    EXPECT_TRUE(matcher.matches("main.h"));
+    EXPECT_TRUE(matcher.matches("abc"));
+}
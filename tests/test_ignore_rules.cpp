@@ -0,0 +1,284 @@
+#include <gtest/gtest.h>
+#include "DirectoryReader.h"
+#include "IgnoreRules.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    using Kind = IgnoreRules::Rule::Kind;
+
+    struct ParseCase {
+        const char* line;
+        std::vector<std::string> segments;
+        Kind kind;
+        bool anchored;
+        bool negated;
+        bool directoryOnly;
+    };
+
+    std::shared_ptr<IgnoreRules::Scope> makeScope(const std::string& base, const char* text,
+                                                   std::shared_ptr<const IgnoreRules::Scope> parent = nullptr) {
+        auto scope = std::make_shared<IgnoreRules::Scope>();
+        scope->base = base;
+        scope->rules = IgnoreRules::parse(text);
+        scope->parent = std::move(parent);
+        return scope;
+    }
+
+    struct IgnoreCase {
+        const char* path;  // относительно /r
+        bool isDirectory;
+        bool ignored;
+    };
+
+    void expectCases(const IgnoreRules::Scope& scope, const std::vector<IgnoreCase>& cases) {
+        for (const auto& c : cases) {
+            fs::path path = fs::path("/r") / c.path;
+            std::string name = path.filename().string();
+            EXPECT_EQ(IgnoreRules::isIgnored(scope, path, name, c.isDirectory), c.ignored)
+                << c.path << (c.isDirectory ? " (директория)" : "");
+        }
+    }
+
+    // Правила корня /r из одного .gitignore; ожидания сверены с git check-ignore
+    const char* ROOT_RULES =
+        "*.log\n"
+        "!important.log\n"
+        "/build\n"
+        "build/\n"
+        "doc/api/\n"
+        "dir/**\n"
+        "**/deep\n"
+        "a/**/b.txt\n"
+        "foo\\ \n"
+        "spaced   \n"
+        "src/anch.txt\n";
+}
+
+TEST(IgnoreRulesParseTest, Table) {
+    const ParseCase cases[] = {
+        {"main.cpp", {"main.cpp"}, Kind::LITERAL, false, false, false},
+        {"*.log", {".log"}, Kind::SUFFIX, false, false, false},
+        {"*.log   ", {".log"}, Kind::SUFFIX, false, false, false},
+        {"*.log\r", {".log"}, Kind::SUFFIX, false, false, false},
+        {"foo\\ ", {"foo\\ "}, Kind::GLOB, false, false, false},
+        {"te?t", {"te?t"}, Kind::GLOB, false, false, false},
+        {"*", {"*"}, Kind::GLOB, false, false, false},
+        {"!important.log", {"important.log"}, Kind::LITERAL, false, true, false},
+        {"\\!bang", {"!bang"}, Kind::LITERAL, false, false, false},
+        {"\\#hash", {"#hash"}, Kind::LITERAL, false, false, false},
+        {"build/", {"build"}, Kind::LITERAL, false, false, true},
+        {"/build", {"build"}, Kind::GLOB, true, false, false},
+        {"doc/api/", {"doc", "api"}, Kind::GLOB, true, false, true},
+        {"dir/**", {"dir", "**"}, Kind::GLOB, true, false, false},
+        {"**/deep", {"**", "deep"}, Kind::GLOB, true, false, false},
+        {"a/**/**/b", {"a", "**", "b"}, Kind::GLOB, true, false, false},
+        {"!/out/", {"out"}, Kind::GLOB, true, true, true},
+    };
+    for (const auto& c : cases) {
+        auto rules = IgnoreRules::parse(c.line);
+        ASSERT_EQ(rules.size(), 1u) << c.line;
+        const auto& rule = rules.front();
+        EXPECT_EQ(rule.segments, c.segments) << c.line;
+        EXPECT_EQ(rule.anchored, c.anchored) << c.line;
+        EXPECT_EQ(rule.negated, c.negated) << c.line;
+        EXPECT_EQ(rule.directoryOnly, c.directoryOnly) << c.line;
+        if (!c.anchored) {
+            EXPECT_EQ(rule.kind, c.kind) << c.line;
+        }
+    }
+}
+
+TEST(IgnoreRulesParseTest, SkipsCommentsBlankLinesAndBareSlashes) {
+    auto rules = IgnoreRules::parse("# comment\n\n   \n/\n!\nkeep\r\n# tail");
+    ASSERT_EQ(rules.size(), 1u);
+    EXPECT_EQ(rules.front().segments, std::vector<std::string>{"keep"});
+}
+
+TEST(IgnoreRulesParseTest, KeepsFileOrder) {
+    auto rules = IgnoreRules::parse("*.log\n!important.log\nbuild/");
+    ASSERT_EQ(rules.size(), 3u);
+    EXPECT_FALSE(rules[0].negated);
+    EXPECT_TRUE(rules[1].negated);
+    EXPECT_TRUE(rules[2].directoryOnly);
+}
+
+TEST(IgnoreRulesMatchTest, SingleFileTable) {
+    auto scope = makeScope("/r", ROOT_RULES);
+    expectCases(*scope, {
+        {"x.log", false, true},
+        {"a/b/y.log", false, true},
+        {"important.log", false, false},       // отрицание ниже по файлу сильнее
+        {"build", false, true},                // "/build" - и файл
+        {"build", true, true},
+        {"src/build", true, true},             // "build/" на любой глубине
+        {"src/build", false, false},           // файл не подходит под "build/"
+        {"doc/api", true, true},
+        {"x/doc/api", true, false},            // "/" в середине привязывает к каталогу правил
+        {"dir", true, false},                  // "dir/**" - только содержимое
+        {"dir/f2", false, true},
+        {"dir/a", true, true},
+        {"dir/a/b/f", false, true},
+        {"deep", false, true},
+        {"a/deep", false, true},
+        {"a/b.txt", false, true},              // "**" - и ноль каталогов
+        {"a/q/b.txt", false, true},
+        {"a/b/b.txt", false, true},
+        {"b.txt", false, false},
+        {"foo ", false, true},                 // экранированный пробел сохраняется
+        {"foo", false, false},
+        {"spaced", false, true},               // неэкранированные - отбрасываются
+        {"spaced ", false, false},
+        {"src/anch.txt", false, true},
+        {"sub/anch.txt", false, false},
+        {".git", true, true},                  // метаданные git - всегда
+    });
+}
+
+TEST(IgnoreRulesMatchTest, DirectoryOnlyRulesSkipSymlinks) {
+    // Обход передает isDirectory = false для симлинка на директорию, как и git
+    auto scope = makeScope("/r", "build/\n");
+    EXPECT_TRUE(IgnoreRules::isIgnored(*scope, "/r/s2/build", "build", true));
+    EXPECT_FALSE(IgnoreRules::isIgnored(*scope, "/r/s2/build", "build", false));
+}
+
+TEST(IgnoreRulesMatchTest, NestedFilesOverrideParents) {
+    auto root = makeScope("/r", ROOT_RULES);
+    auto sub = makeScope("/r/sub", "!keep.log\n*.tmp\n/gen\n", root);
+    auto inSub = [&](const char* path, bool isDirectory) {
+        fs::path full = fs::path("/r") / path;
+        return IgnoreRules::isIgnored(*sub, full, full.filename().string(), isDirectory);
+    };
+    auto inRoot = [&](const char* path, bool isDirectory) {
+        fs::path full = fs::path("/r") / path;
+        return IgnoreRules::isIgnored(*root, full, full.filename().string(), isDirectory);
+    };
+    EXPECT_FALSE(inSub("sub/keep.log", false));  // отрицание во вложенном файле
+    EXPECT_TRUE(inSub("sub/other.log", false));  // правило родителя действует
+    EXPECT_TRUE(inSub("sub/a.tmp", false));
+    EXPECT_TRUE(inSub("sub/gen", true));         // "/gen" привязан к sub
+    EXPECT_TRUE(inRoot("keep.log", false));
+    EXPECT_FALSE(inRoot("a.tmp", false));
+    EXPECT_FALSE(inRoot("gen", true));
+}
+
+TEST(IgnoreRulesMatchTest, NegationOrderWithinAndAcrossFiles) {
+    // Внутри файла решает последнее совпадение, вложенный файл сильнее родителя
+    auto root = makeScope("/r", "!*.txt\n*.txt\n");
+    EXPECT_TRUE(IgnoreRules::isIgnored(*root, "/r/a.txt", "a.txt", false));
+    auto sub = makeScope("/r/sub", "!a.txt\n", root);
+    EXPECT_FALSE(IgnoreRules::isIgnored(*sub, "/r/sub/a.txt", "a.txt", false));
+    EXPECT_TRUE(IgnoreRules::isIgnored(*sub, "/r/sub/b.txt", "b.txt", false));
+    auto reignore = makeScope("/r/sub/deeper", "a.txt\n", sub);
+    EXPECT_TRUE(IgnoreRules::isIgnored(*reignore, "/r/sub/deeper/a.txt", "a.txt", false));
+}
+
+class IgnoreRulesTreeTest : public ::testing::Test {
+protected:
+    fs::path root_;
+
+    void SetUp() override {
+        std::string pattern = (fs::temp_directory_path() / "tree-utility-ignore-XXXXXX").string();
+        ASSERT_NE(mkdtemp(pattern.data()), nullptr);
+        root_ = pattern;
+        fs::create_directories(root_ / ".git" / "info");
+        write(".git/info/exclude", "secret\n");
+        write(".gitignore", ROOT_RULES);
+        write("sub/.gitignore", "!keep.log\n*.tmp\n/gen\n");
+        for (const char* file : {"x.log", "important.log", "a/b/y.log", "build", "src/build/f", "src/gen/f",
+                                 "doc/api/f", "x/doc/api/f", "dir/a/b/f", "dir/f2", "deep", "a/deep",
+                                 "a/b.txt", "a/q/b.txt", "a/b/b.txt", "foo ", "foo", "spaced", "spaced ",
+                                 "src/anch.txt", "sub/anch.txt", "sub/keep.log", "sub/other.log", "keep.log",
+                                 "sub/a.tmp", "a.tmp", "sub/gen/f", "gen", "sub/secret", "real/f"}) {
+            write(file, "");
+        }
+        fs::create_directories(root_ / "s2");
+        fs::create_directory_symlink("../real", root_ / "s2" / "build");
+    }
+
+    void TearDown() override {
+        std::error_code ec;
+        fs::remove_all(root_, ec);
+    }
+
+    void write(const std::string& relative, const std::string& text) {
+        fs::create_directories((root_ / relative).parent_path());
+        std::ofstream(root_ / relative) << text;
+    }
+
+    // Обход как в TreeBuilder: правила каталога по его листингу, симлинк - не директория
+    std::set<std::string> visible(const fs::path& start) {
+        IgnoreRules rules(start);
+        std::set<std::string> result;
+        walk(rules, start, "", result);
+        return result;
+    }
+
+    void walk(IgnoreRules& rules, const fs::path& dir, const std::string& prefix, std::set<std::string>& result) {
+        std::vector<DirectoryReader::Entry> entries;
+        ASSERT_TRUE(DirectoryReader::readEntries(dir, entries));
+        const IgnoreRules::Scope* scope = rules.scopeFor(dir, entries);
+        for (const auto& entry : entries) {
+            fs::path path = dir / entry.name;
+            bool isDirectory = entry.type == DirectoryReader::EntryType::UNKNOWN
+                ? fs::is_directory(fs::symlink_status(path))
+                : entry.type == DirectoryReader::EntryType::DIRECTORY;
+            if (scope && IgnoreRules::isIgnored(*scope, path, entry.name, isDirectory)) {
+                continue;
+            }
+            if (isDirectory) {
+                walk(rules, path, prefix + entry.name + "/", result);
+            } else {
+                result.insert(prefix + entry.name);
+            }
+        }
+    }
+};
+
+TEST_F(IgnoreRulesTreeTest, WholeRepositoryMatchesGit) {
+    // Список совпадает с git ls-files -o --exclude-standard на том же дереве
+    std::set<std::string> expected = {
+        ".gitignore", "important.log", "x/doc/api/f", "src/gen/f", "foo", "spaced ",
+        "sub/.gitignore", "sub/anch.txt", "sub/keep.log", "a.tmp", "gen", "real/f", "s2/build",
+    };
+    EXPECT_EQ(visible(root_), expected);
+}
+
+TEST_F(IgnoreRulesTreeTest, RulesAboveTheScanRootApply) {
+    // Обход из sub: правила корня репозитория и .git/info/exclude тоже действуют,
+    // привязанные шаблоны корня сравниваются с путем относительно корня
+    std::set<std::string> expected = {".gitignore", "anch.txt", "keep.log"};
+    EXPECT_EQ(visible(root_ / "sub"), expected);
+
+    std::set<std::string> fromSrc = {"gen/f"};
+    EXPECT_EQ(visible(root_ / "src"), fromSrc);
+}
+
+TEST_F(IgnoreRulesTreeTest, RemovedRulesFileStopsApplying) {
+    // Повторный листинг без .gitignore (как при --watch) снимает правила каталога
+    IgnoreRules rules(root_);
+    std::vector<DirectoryReader::Entry> entries;
+    ASSERT_TRUE(DirectoryReader::readEntries(root_, entries));
+    ASSERT_NE(rules.scopeFor(root_, entries), nullptr);  // родитель читается раньше
+    entries.clear();
+    ASSERT_TRUE(DirectoryReader::readEntries(root_ / "sub", entries));
+    const IgnoreRules::Scope* scope = rules.scopeFor(root_ / "sub", entries);
+    ASSERT_NE(scope, nullptr);
+    EXPECT_TRUE(IgnoreRules::isIgnored(*scope, root_ / "sub" / "a.tmp", "a.tmp", false));
+
+    fs::remove(root_ / "sub" / ".gitignore");
+    entries.clear();
+    ASSERT_TRUE(DirectoryReader::readEntries(root_ / "sub", entries));
+    scope = rules.scopeFor(root_ / "sub", entries);
+    ASSERT_NE(scope, nullptr);
+    EXPECT_FALSE(IgnoreRules::isIgnored(*scope, root_ / "sub" / "a.tmp", "a.tmp", false));
+    EXPECT_TRUE(IgnoreRules::isIgnored(*scope, root_ / "sub" / "keep.log", "keep.log", false));
+}